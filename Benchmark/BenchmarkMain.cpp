@@ -0,0 +1,180 @@
+// Microbenchmarks for the game's hot paths.
+//
+// usage: Benchmark [--json FILE] [--filter TEXT] [--min-time SECONDS]
+//
+// Prints a table of ns/op and allocations/op, and with --json writes the
+// same results as JSON for diffing between builds.
+// TetrisGame itself needs a window, so the game step benchmarks drive the
+// TetrisSimulation it wraps (the same calls TetrisGame makes).
+
+#include "BenchmarkRunner.h"
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "TetrisSimulation.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const int BOARDS_PER_BATCH = 256;
+
+	// a board with a ragged stack in the bottom rows, and `completed` full rows under it
+	void buildBoard(Gameboard& board, int completed)
+	{
+		board.empty();
+		for (int y = Gameboard::MAX_Y - 1; y >= Gameboard::MAX_Y - 8; y--)
+		{
+			const bool full = y >= Gameboard::MAX_Y - completed;
+			for (int x = 0; x < Gameboard::MAX_X; x++)
+			{
+				if (full || (x * 7 + y * 3) % 5 != 0)
+				{
+					board.setContent(x, y, (x + y) % 7);
+				}
+			}
+		}
+	}
+
+	// a simulation partway through a game (a few shapes dropped across the board)
+	void startGame(TetrisSimulation& simulation)
+	{
+		simulation.newGame(7, RandomizerMode::BAG);
+		const GameInput moves[] = { GameInput::LEFT, GameInput::RIGHT, GameInput::LEFT, GameInput::RIGHT };
+		for (int piece = 0; piece < 8; piece++)
+		{
+			for (int step = 0; step < piece % 5; step++)
+			{
+				simulation.applyInput(moves[piece % 4]);
+			}
+			simulation.applyInput(GameInput::HARD_DROP);
+			simulation.processGameLoop(0.0f);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string jsonPath;
+	std::string filter;
+	double minSeconds = 1.0;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		const std::string option{ argv[i] };
+		if (option == "--json") jsonPath = argv[i + 1];
+		else if (option == "--filter") filter = argv[i + 1];
+		else if (option == "--min-time") minSeconds = std::atof(argv[i + 1]);
+		else {
+			std::cerr << "usage: Benchmark [--json FILE] [--filter TEXT] [--min-time SECONDS]\n";
+			return 1;
+		}
+	}
+	BenchmarkRunner runner(minSeconds, filter);
+
+	// Gameboard ======================================================
+	{
+		Gameboard board;
+		buildBoard(board, 0);
+		GridTetromino shape;
+		shape.setShape(TetShape::T);
+		// in empty space, inside the stack, against the wall
+		const int spots[3][2] = { { 4, 2 }, { 4, 12 }, { 0, 5 } };
+		BlockLocs locs[3];
+		for (int i = 0; i < 3; i++)
+		{
+			shape.setGridLoc(spots[i][0], spots[i][1]);
+			locs[i] = shape.getBlockLocsMappedToGrid();
+		}
+		runner.run("Gameboard::areAllLocsEmpty", 1024, [] {},
+			[&](int i) { return board.areAllLocsEmpty(locs[i % 3]) ? 1 : 0; });
+	}
+	for (int lines = 0; lines <= 4; lines++)
+	{
+		std::vector<Gameboard> boards(BOARDS_PER_BATCH);
+		runner.run("Gameboard::removeCompletedRows/" + std::to_string(lines) + "_lines", BOARDS_PER_BATCH,
+			[&] {
+				for (Gameboard& board : boards)
+				{
+					buildBoard(board, lines);
+				}
+			},
+			[&](int i) { return boards[i].removeCompletedRows(); });
+	}
+
+	// Tetromino & GridTetromino ======================================
+	{
+		GridTetromino shapes[static_cast<int>(TetShape::COUNT)];
+		for (int i = 0; i < static_cast<int>(TetShape::COUNT); i++)
+		{
+			shapes[i].setShape(static_cast<TetShape>(i));
+			shapes[i].setGridLoc(4, 6);
+		}
+		runner.run("GridTetromino::getBlockLocsMappedToGrid", 1024, [] {},
+			[&](int i) {
+				GridTetromino& shape = shapes[i % static_cast<int>(TetShape::COUNT)];
+				shape.rotateClockwise();
+				const BlockLocs locs = shape.getBlockLocsMappedToGrid();
+				return locs[0].getX() + locs[3].getY();
+			});
+	}
+
+	// TetrisSimulation primitives ====================================
+	{
+		TetrisSimulation simulation;
+		startGame(simulation);
+		GridTetromino shape = simulation.getCurrentShape();
+		shape.move(0, 2);
+		runner.run("TetrisSimulation::attemptMove", 1024, [] {},
+			[&](int i) { return simulation.attemptMove(shape, (i & 2) ? 1 : -1, 0) ? 1 : 0; });
+		runner.run("TetrisSimulation::attemptRotate", 1024, [] {},
+			[&](int) { return simulation.attemptRotate(shape) ? 1 : 0; });
+		runner.run("TetrisSimulation::drop", 1024, [] {},
+			[&](int i) {
+				GridTetromino dropped{ shape };
+				dropped.move((i % 5) - 2, 0);
+				simulation.drop(dropped);
+				return dropped.getGridLoc().getY();
+			});
+	}
+
+	// full game steps ================================================
+	{
+		// a player tapping keys every few frames at 60 FPS, shapes locking and rows clearing as they go
+		TetrisSimulation simulation;
+		const GameInput inputs[] = { GameInput::LEFT, GameInput::ROTATE, GameInput::RIGHT, GameInput::RIGHT,
+			GameInput::SOFT_DROP, GameInput::LEFT, GameInput::HARD_DROP };
+		unsigned int step = 0;
+		runner.run("TetrisSimulation::game_step", 1024, [] {},
+			[&](int) {
+				step++;
+				if (step % 4 == 0)
+				{
+					simulation.applyInput(inputs[(step / 4) % 7]);
+				}
+				simulation.processGameLoop(1.0f / 60.0f);
+				return simulation.getScore();
+			});
+		runner.run("TetrisSimulation::hard_drop_piece", 1024, [] {},
+			[&](int i) {
+				simulation.applyInput((i & 1) ? GameInput::LEFT : GameInput::RIGHT);
+				simulation.applyInput(GameInput::HARD_DROP);
+				simulation.processGameLoop(0.0f);
+				return simulation.getPiecesLocked();
+			});
+	}
+
+	runner.printTable(std::cout);
+	if (!jsonPath.empty())
+	{
+		std::ofstream json(jsonPath);
+		runner.writeJson(json);
+		if (!json)
+		{
+			std::cerr << "Unable to write " << jsonPath << "\n";
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,37 @@
+#include "BenchmarkRunner.h"
+#include <cstdio>
+
+// print the results as an aligned table
+// - param 1: the stream
+// - return: nothing
+void BenchmarkRunner::printTable(std::ostream& out) const
+{
+	char line[160];
+	std::snprintf(line, sizeof(line), "%-40s %14s %12s %12s\n", "benchmark", "iterations", "ns/op", "allocs/op");
+	out << line;
+	for (const Result& result : results)
+	{
+		std::snprintf(line, sizeof(line), "%-40s %14lld %12.2f %12.3f\n",
+			result.name.c_str(), result.iterations, result.nsPerOp, result.allocationsPerOp);
+		out << line;
+	}
+}
+
+// write the results as JSON
+// - param 1: the stream
+// - return: nothing
+void BenchmarkRunner::writeJson(std::ostream& out) const
+{
+	char line[256];
+	out << "{\n  \"benchmarks\": [\n";
+	for (std::size_t i = 0; i < results.size(); i++)
+	{
+		const Result& result = results[i];
+		std::snprintf(line, sizeof(line),
+			"    { \"name\": \"%s\", \"iterations\": %lld, \"ns_per_op\": %.3f, \"allocations_per_op\": %.4f }%s\n",
+			result.name.c_str(), result.iterations, result.nsPerOp, result.allocationsPerOp,
+			i + 1 < results.size() ? "," : "");
+		out << line;
+	}
+	out << "  ]\n}\n";
+}
@@ -0,0 +1,120 @@
+// A small microbenchmark harness.
+//
+// run() times a body in batches: an untimed setup() prepares each batch
+// (eg: refills the boards the batch will clear), then body(i) is called
+// batchSize times under the clock. Batches repeat until a repetition has run
+// for long enough, and the fastest of several repetitions is reported, which
+// is the most stable figure between runs on a busy machine.
+// Heap allocations made by the timed bodies are counted with AllocationCounter.
+//
+// Bodies return an int that is folded into a volatile sink, so the compiler
+// can't throw the work away.
+
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include "AllocationCounter.h"
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class BenchmarkRunner
+{
+public:
+	struct Result
+	{
+		std::string name;
+		long long iterations;		// timed body calls, over all repetitions
+		double nsPerOp;				// the fastest repetition
+		double allocationsPerOp;	// over all repetitions
+	};
+
+	static const int REPETITIONS = 5;
+
+private:
+	double secondsPerRepetition;
+	std::string filter;				// only run benchmarks whose name contains this
+	std::vector<Result> results;
+	volatile int sink{ 0 };
+
+public:
+	// constructor
+	// - param 1: the minimum time each benchmark runs for (split over the repetitions)
+	// - param 2: a name filter, empty runs everything
+	BenchmarkRunner(double minSeconds, const std::string& filter)
+		: secondsPerRepetition{ minSeconds / REPETITIONS }, filter(filter)
+	{
+	}
+
+	// time a benchmark and add its Result
+	// - param 1: the benchmark name
+	// - param 2: the number of body calls per setup
+	// - param 3: void setup(), untimed, called before every batch
+	// - param 4: int body(int i), timed, i is the call's index in the batch
+	// - return: nothing
+	template <typename Setup, typename Body>
+	void run(const std::string& name, int batchSize, Setup setup, Body body)
+	{
+		if (!filter.empty() && name.find(filter) == std::string::npos)
+		{
+			return;
+		}
+		using Clock = std::chrono::steady_clock;
+
+		// warm up (caches, branch predictors, lazy initialization)
+		setup();
+		for (int i = 0; i < batchSize; i++)
+		{
+			sink = sink + body(i);
+		}
+
+		Result result{ name, 0, 0.0, 0.0 };
+		long long allocations = 0;
+		for (int repetition = 0; repetition < REPETITIONS; repetition++)
+		{
+			double seconds = 0.0;
+			long long iterations = 0;
+			while (seconds < secondsPerRepetition)
+			{
+				setup();
+				const long long allocationsBefore = AllocationCounter::getAllocationCount();
+				const Clock::time_point start = Clock::now();
+				for (int i = 0; i < batchSize; i++)
+				{
+					sink = sink + body(i);
+				}
+				const Clock::time_point end = Clock::now();
+				allocations += AllocationCounter::getAllocationCount() - allocationsBefore;
+				seconds += std::chrono::duration<double>(end - start).count();
+				iterations += batchSize;
+			}
+			const double nsPerOp = seconds * 1.0e9 / iterations;
+			if (repetition == 0 || nsPerOp < result.nsPerOp)
+			{
+				result.nsPerOp = nsPerOp;
+			}
+			result.iterations += iterations;
+		}
+		result.allocationsPerOp = static_cast<double>(allocations) / result.iterations;
+		results.push_back(result);
+	}
+
+	const std::vector<Result>& getResults() const
+	{
+		return results;
+	}
+
+	// print the results as an aligned table
+	// - param 1: the stream
+	// - return: nothing
+	void printTable(std::ostream& out) const;
+
+	// write the results as JSON (one benchmark per line, always in run order,
+	// fixed number formats) so results from two builds can be diffed
+	// - param 1: the stream
+	// - return: nothing
+	void writeJson(std::ostream& out) const;
+};
+
+#endif /* BENCHMARKRUNNER_H */
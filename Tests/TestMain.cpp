@@ -0,0 +1,39 @@
+// Runs the TestSuite.
+//
+// usage: Tests [--threads N] [--filter TEXT] [--verbose]
+//
+// Exits 0 once every selected case has passed. A failing case asserts,
+// which ends the run with the failed check's message.
+
+#include "TestSuite.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+	unsigned int threadCount = std::thread::hardware_concurrency();
+	std::string filter;
+	bool verbose = false;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string option{ argv[i] };
+		if (option == "--threads" && i + 1 < argc) threadCount = static_cast<unsigned int>(std::atoi(argv[++i]));
+		else if (option == "--filter" && i + 1 < argc) filter = argv[++i];
+		else if (option == "--verbose") verbose = true;
+		else {
+			std::cerr << "usage: Tests [--threads N] [--filter TEXT] [--verbose]\n";
+			return 1;
+		}
+	}
+
+	const int caseCount = TestSuite::runTestSuite(threadCount > 0 ? threadCount : 1, filter, verbose);
+	if (caseCount == 0)
+	{
+		std::cerr << "No test cases match \"" << filter << "\"\n";
+		return 1;
+	}
+	std::cout << caseCount << " test cases passed\n";
+	return 0;
+}
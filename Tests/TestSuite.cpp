@@ -0,0 +1,1496 @@
+// asserts are how the cases fail, so keep them in release builds of the tests too
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#include "TestSuite.h"
+#include "AutoShift.h"
+#include "FrameProfiler.h"
+#include "Point.h"
+#include "Tetromino.h"
+#include "Gameboard.h"
+#include "GameSnapshot.h"
+#include "InputStage.h"
+#include "GridTetromino.h"
+#include "TetrisSimulation.h"
+#include "PieceRandomizer.h"
+#include "PlacementGenerator.h"
+#include "ReachabilitySearch.h"
+#include "TaskPool.h"
+#include "TickScheduler.h"
+#include "TripleBuffer.h"
+#include "WakeSignal.h"
+#include "TetrisBot.h"
+#include "ReplayFormat.h"
+#include "ReplayPlayer.h"
+#include "ReplayRecorder.h"
+#include "SpscQueue.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+const TestSuite::TestCase TestSuite::TEST_CASES[] = {
+	{ "Point", &TestSuite::testPointClass, true },			// these 3 print to std::cout
+	{ "Tetromino", &TestSuite::testTetrominoClass, true },
+	{ "Gameboard", &TestSuite::testGameboardClass, true },
+	{ "GridTetromino", &TestSuite::testGridTetrominoClass, false },
+	{ "TetrisSimulation", &TestSuite::testTetrisSimulationClass, false },
+	{ "PieceRandomizer", &TestSuite::testPieceRandomizerClass, false },
+	{ "PlacementGenerator", &TestSuite::testPlacementGeneratorClass, false },
+	{ "ReachabilitySearch", &TestSuite::testReachabilitySearchClass, false },
+	{ "TaskPool", &TestSuite::testTaskPoolClass, false },
+	{ "TickScheduler", &TestSuite::testTickSchedulerClass, false },
+	{ "InputStage", &TestSuite::testInputStageClass, false },
+	{ "AutoShift", &TestSuite::testAutoShiftClass, false },
+	{ "SpscQueue", &TestSuite::testSpscQueueClass, false },
+	{ "TripleBuffer", &TestSuite::testTripleBufferClass, false },
+	{ "WakeSignal", &TestSuite::testWakeSignalClass, false },
+	{ "FrameProfiler", &TestSuite::testFrameProfilerClass, false },
+	{ "TetrisBot", &TestSuite::testTetrisBotClass, false },
+	{ "Replay", &TestSuite::testReplayClasses, false },
+	{ "AllocationCounter", &TestSuite::testHotPathAllocations, true },	// counts every thread's allocations
+};
+const int TestSuite::TEST_CASE_COUNT = sizeof(TEST_CASES) / sizeof(TEST_CASES[0]);
+
+// run every test case whose name contains filter, and report each one
+// - param 1: the number of threads to run cases on (1 runs them in order)
+// - param 2: only run cases with this in their name ("" runs them all)
+// - param 3: show what the cases print to the console, otherwise it's discarded
+// - return: the number of cases run
+int TestSuite::runTestSuite(unsigned int threadCount, const std::string& filter, bool verbose)
+{
+	std::vector<const TestCase*> parallelCases;
+	std::vector<const TestCase*> exclusiveCases;
+	for (int i = 0; i < TEST_CASE_COUNT; i++)
+	{
+		if (std::string(TEST_CASES[i].name).find(filter) != std::string::npos)
+		{
+			(TEST_CASES[i].exclusive ? exclusiveCases : parallelCases).push_back(&TEST_CASES[i]);
+		}
+	}
+
+	// The cases that print their boards & shapes are exclusive, so only they
+	// write to std::cout, one at a time, once the parallel cases are done.
+	std::ostream report(std::cout.rdbuf());
+	std::ostringstream discarded;
+	std::mutex reportMutex;
+	auto runCase = [&](const TestCase& testCase)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		testCase.run();
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		std::lock_guard<std::mutex> lock(reportMutex);
+		report << "passed " << testCase.name << " ("
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms)" << std::endl;
+	};
+
+	auto runParallelCase = [&](int index) { runCase(*parallelCases[index]); };
+	{
+		TaskPool pool(threadCount > 1 ? threadCount - 1 : 0);
+		pool.parallelFor(static_cast<int>(parallelCases.size()), runParallelCase);
+	}
+
+	// no worker threads are left, so std::cout can be redirected safely
+	if (!verbose)
+	{
+		std::cout.rdbuf(discarded.rdbuf());
+	}
+	for (const TestCase* testCase : exclusiveCases)
+	{
+		runCase(*testCase);
+	}
+	std::cout.rdbuf(report.rdbuf());
+	return static_cast<int>(parallelCases.size() + exclusiveCases.size());
+}
+
+void TestSuite::testPointClass()
+{
+	//std::cout << "testPointClass()...\n";
+
+	Point p;
+
+	// test our initial values are 0,0
+	assert(p.getX() == 0 && "Point ctor - x not initialized to 0");
+	assert(p.getY() == 0 && "Point ctor - y not initialized to 0");
+
+	// test setX()
+	p.setX(1);
+	assert(p.getX() == 1 && "Point::setX() failed");
+	p.setX(-1);
+	assert(p.getX() == -1 && "Point::setX() failed");
+
+	// test setY()
+	p.setY(2);
+	assert(p.getY() == 2 && "Point::setY() failed");
+	p.setY(-2);
+	assert(p.getY() == -2 && "Point::setY() failed");
+
+	// test setXY()
+	p.setXY(3, 4);
+	assert(p.getX() == 3 && p.getY() == 4 && "Point::setXY() failed");
+	p.setXY(-3, -4);
+	assert(p.getX() == -3 && p.getY() == -4 && "Point::setXY() failed");
+
+	// test constructor with 2 params
+	Point q(3, 4);
+	assert(q.getX() == 3 && q.getY() == 4 && "Point::ctor failed to set default params");
+
+	// test swapXY()
+	q.swapXY();
+	assert(q.getX() == 4 && q.getY() == 3 && "Point::swapXY() failed");
+
+	// test multiplyX()
+	q.multiplyX(-1);
+	assert(q.getX() == -4 && "Point::multiplyX() failed");
+
+	// test multiplyY()
+	q.multiplyY(-1);
+	assert(q.getY() == -3 && "Point::multiplyY() failed");
+
+	// test copy constructor
+	q.setXY(1, 2);
+	Point r = q;
+	assert(r.getX() == q.getX() && r.getY() == q.getY() && "Point copy ctor failed");
+	r.setXY(3, 4);
+	assert(r.getX() == 3 && r.getY() == 4
+		&& q.getX() == 1 && q.getY() == 2 && "Point::setXY() failed");
+
+	Point s{ 5,6 };
+	std::cout << "expected:\t[5,6]\n";
+	std::cout << "actual: \t" << s.toString() << "\n";
+
+	// ensure const methods are actually const
+	// These lines will cause compile time errors you have methods in your Point class that
+	// should be labelled as const (because the methods don't change the internal member
+	// variables of yoru class).
+	// The solution: make these const methods!  (see LearnCpp 13.2- const class objects and member functions)
+	const Point cPoint{};
+	cPoint.getX();
+	cPoint.getY();
+	cPoint.toString();
+
+
+}
+
+
+
+void TestSuite::testTetrominoClass()
+{
+
+	Tetromino t;
+
+
+	assert(t.getColor() == TetColor::RED ||
+		t.getColor() == TetColor::ORANGE ||
+		t.getColor() == TetColor::YELLOW ||
+		t.getColor() == TetColor::GREEN ||
+		t.getColor() == TetColor::BLUE_LIGHT ||
+		t.getColor() == TetColor::BLUE_DARK ||
+		t.getColor() == TetColor::PURPLE &&
+		"default Tetromino not initialized to valid color.");
+
+	assert(t.getShape() == TetShape::S ||
+		t.getShape() == TetShape::Z ||
+		t.getShape() == TetShape::L ||
+		t.getShape() == TetShape::J ||
+		t.getShape() == TetShape::O ||
+		t.getShape() == TetShape::I ||
+		t.getShape() == TetShape::T &&
+		"default Tetromino not initialized to valid shape.");
+
+	// every layout in the rotation table should have BLOCK_COUNT distinct blocks,
+	// including the pivot block at [0,0], inside its bounding box
+	for (int shape = 0; shape < static_cast<int>(TetShape::COUNT); shape++) {
+		t.setShape(static_cast<TetShape>(shape));
+		assert(t.getRotation() == 0 && "Tetromino::setShape() should reset the rotation");
+		for (int rotation = 0; rotation < Tetromino::ROTATION_COUNT; rotation++) {
+			const TetrominoLayout& layout = t.getLayout();
+			assert(layout.blocks[0].x == 0 && layout.blocks[0].y == 0 && "Tetromino layout should start with the pivot block");
+			for (int i = 0; i < BLOCK_COUNT; i++) {
+				assert(layout.blocks[i].x >= layout.minX && layout.blocks[i].x <= layout.maxX &&
+					layout.blocks[i].y >= layout.minY && layout.blocks[i].y <= layout.maxY &&
+					"Tetromino layout block outside its bounding box");
+				for (int j = i + 1; j < BLOCK_COUNT; j++) {
+					assert((layout.blocks[i].x != layout.blocks[j].x || layout.blocks[i].y != layout.blocks[j].y) &&
+						"Tetromino layout has overlapping blocks");
+				}
+			}
+			t.rotateClockwise();
+		}
+		assert(t.getRotation() == 0 && "Tetromino::rotateClockwise() should wrap after 4 rotations");
+	}
+
+	// test the rotate functionality, each block [x,y] rotates to [y,-x]
+	t.setShape(TetShape::L);
+	for (int rotation = 0; rotation < Tetromino::ROTATION_COUNT; rotation++) {
+		const TetrominoLayout before = t.getLayout();
+		t.rotateClockwise();
+		for (int i = 0; i < BLOCK_COUNT; i++) {
+			assert(t.getLayout().blocks[i].x == before.blocks[i].y &&
+				t.getLayout().blocks[i].y == -before.blocks[i].x && "Tetromino::rotateClockwise() failed");
+		}
+	}
+	assert(t.getLayout().blocks[2].x == 1 && t.getLayout().blocks[2].y == -1 && "Tetromino::rotateClockwise() failed");
+	t.rotateClockwise();
+	assert(t.getLayout().blocks[2].x == -1 && t.getLayout().blocks[2].y == -1 && "Tetromino::rotateClockwise() failed");
+
+	// the O shape doesn't rotate
+	t.setShape(TetShape::O);
+	t.rotateClockwise();
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		assert(t.getLayout().blocks[i].x == Tetromino::getLayout(TetShape::O, 0).blocks[i].x &&
+			t.getLayout().blocks[i].y == Tetromino::getLayout(TetShape::O, 0).blocks[i].y &&
+			"Tetromino::rotateClockwise() should not move the blocks of an O");
+	}
+
+	// ensure const methods are actually const
+	// These lines will cause compile time errors you have methods in your Tetromino class that
+	// should be labelled as const (because the methods don't change the internal member
+	// variables of yoru class).
+	// (see LearnCpp 13.2- const class objects and member functions)
+	const Tetromino cTetromino;
+	cTetromino.printToConsole();
+	cTetromino.getColor();
+	cTetromino.getShape();
+
+	// Test const 
+
+}
+
+bool isGameboardEmpty(Gameboard& g)
+{
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		for (int y = 0; y < Gameboard::MAX_Y; y++)
+		{
+			if (g.getContent(x, y) != Gameboard::EMPTY_BLOCK) { return false; }
+		}
+	}
+	return true;
+}
+
+
+void TestSuite::testGameboardClass()
+{
+	Gameboard g;
+	// test if grid content is initialized to empty blocks
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		for (int y = 0; y < Gameboard::MAX_Y; y++) {
+			assert(g.getContent(x, y) == Gameboard::EMPTY_BLOCK && "Gameboard was not initialized with empty blocks");
+		}
+	}
+
+	// test setGridContent()
+	g.setContent(0, 0, 1);
+	assert(g.getContent(0, 0) == 1 && "Gameboard.setContent() - unexpected result");	// was grid content set?
+	g.setContent(Gameboard::MAX_X - 1, Gameboard::MAX_Y - 1, 2);
+	assert(g.getContent(Gameboard::MAX_X - 1, Gameboard::MAX_Y - 1) == 2 &&
+		"Gameboard.setContent() - unexpected result"); // was grid content set?
+	g.setContent(Gameboard::MAX_X - 1, Gameboard::MAX_Y - 1, Gameboard::EMPTY_BLOCK);
+	assert(g.getContent(Gameboard::MAX_X - 1, Gameboard::MAX_Y - 1) == Gameboard::EMPTY_BLOCK &&
+		"Gameboard.setContent() - unexpected result"); // was grid content set?
+
+
+	// test fillRow() & isRowCompleted()
+	g.fillRow(0, 1);
+	assert(g.getContent(0, 0) == 1 &&
+		"Gameboard.fillRow() - row should be filled with 1, but first element is not 1");	// is the first spot in the row what we expect?
+	assert(g.getContent(Gameboard::MAX_X - 1, 0) == 1 &&
+		"Gameboard.fillRow() - row should be filled, but last element is still 1");  // is the last spot in the row what we expect?
+	assert(g.isRowCompleted(0) == true &&
+		"Gameboard.fillRow() - row should be filled, but does not appear to be completed");	// was row 0 completed?
+
+	// test isRowCompleted()
+	g.setContent(0, 0, Gameboard::EMPTY_BLOCK);
+	assert(g.isRowCompleted(0) == false &&
+		"Gameboard.isRowCompleted() clearing a single entry should make row incomplete");	// did a single incomplete entry make the row incomplete?
+
+	// test clearRow()
+	g.fillRow(0, 1);
+	assert(g.isRowCompleted(0) == true &&
+		"Gameboard.fillRow() - row should be filled with 1, but does not appear to be completed");	// ensure row filled
+	g.fillRow(0, Gameboard::EMPTY_BLOCK);
+	assert(g.isRowCompleted(0) == false &&
+		"Gameboard.fillRow() - row should be empty, but appears to be completed");	// did row 0 get cleared
+
+	// test isEmpty
+	g.empty();
+	assert(isGameboardEmpty(g) == true && "Gameboard.isGameboardEmpty() returned false when true expected");
+	g.setContent(0, 0, 1);
+	assert(isGameboardEmpty(g) == false && "Gameboard.isGameboardEmpty() returned true when false expected");
+	g.empty();
+	assert(isGameboardEmpty(g) == true && "Gameboard.isGameboardEmpty() returned false when true expected");
+
+	// test empty()
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {	// fill the whole board
+		g.fillRow(y, 1);
+	}
+	g.empty();	// empty the board
+	assert(isGameboardEmpty(g) == true &&
+		"Gameboard.isGameboardEmpty() returned false when true expected"); // verify the board is empty
+
+	// test copyRowIntoRow()
+	g.empty();
+	assert(g.isRowCompleted(1) == false);
+	for (int x = 0; x < Gameboard::MAX_X; x++) {  // fill row 0 with 0, 1, 2, 3,...
+		g.setContent(x, 1, x);
+	}
+	g.copyRowIntoRow(1, 3);					// copy row 0 into row 1
+	assert(g.isRowCompleted(3) == true);	// row 3 should now be completed
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		assert(g.getContent(x, 1) == g.getContent(x, 3) &&
+			"Gameboard.copyRowIntoRow(), rows expected to match but do not"); // compare row 1 with row 3, does it match?
+	}
+
+	// test removeRow()
+	g.fillRow(0, 0);
+	g.fillRow(1, 1);
+	g.fillRow(2, 2);
+	g.removeRow(2);
+	assert(g.getContent(0, 0) == Gameboard::EMPTY_BLOCK && "Gameboard.removeRow() expected row to be empty, but it is not");
+	assert(g.getContent(0, 1) == 0 && "Gameboard.removeRow() expected row to be empty, but it is not");
+	assert(g.getContent(0, 2) == 1 && "Gameboard.removeRow() expected row to be empty, but it is not");
+
+	// test removeRows()
+	g.empty();
+	g.fillRow(0, 0);
+	g.fillRow(1, 1);
+	g.fillRow(2, 2);
+	g.fillRow(3, 3);
+	g.fillRow(4, 4);
+	std::vector<int> rowsToRemove = { 1, 3 };
+	g.removeRows(rowsToRemove);
+	assert(g.getContent(0, 0) == Gameboard::EMPTY_BLOCK && "Gameboard.removeRows() seems to have failed");
+	assert(g.getContent(0, 1) == Gameboard::EMPTY_BLOCK && "Gameboard.removeRows() seems to have failed");
+	assert(g.getContent(0, 2) == 0 && "Gameboard.removeRows() seems to have failed");
+	assert(g.getContent(0, 3) == 2 && "Gameboard.removeRows() seems to have failed");
+	assert(g.getContent(0, 4) == 4 && "Gameboard.removeRows() seems to have failed");
+
+	// test getRowMask()
+	g.empty();
+	assert(g.getRowMask(0) == 0 && "Gameboard.getRowMask() expected an empty row mask");
+	g.setContent(0, 0, 1);
+	g.setContent(Gameboard::MAX_X - 1, 0, 1);
+	assert(g.getRowMask(0) == (1 | (1 << (Gameboard::MAX_X - 1))) &&
+		"Gameboard.getRowMask() does not match the row content");
+	g.setContent(0, 0, Gameboard::EMPTY_BLOCK);
+	assert(g.getRowMask(0) == (1 << (Gameboard::MAX_X - 1)) &&
+		"Gameboard.getRowMask() was not updated when a block was emptied");
+	g.fillRow(1, 3);
+	assert(g.getRowMask(1) == Gameboard::FULL_ROW && "Gameboard.getRowMask() expected FULL_ROW");
+
+	// test getCompletedRowIndices()
+	g.empty();
+	assert(g.getCompletedRowIndices().size() == 0 &&
+		"Gameboard.getCompletedRowIndices() should be empty");
+	g.fillRow(2, 1);	// complete row 2
+	g.fillRow(4, 1);	// complete row 4
+	std::vector<int> completedRows = g.getCompletedRowIndices();
+	// did it return the right rows?
+	assert(completedRows.size() == 2 && completedRows[0] == 2 && completedRows[1] == 4 &&
+		"Gameboard.getCompletedRowIndices() does not return expected results");
+
+	// test removeCompletedRows()
+	g.empty();
+	assert(g.removeCompletedRows() == 0 && "Gameboard.removeCompletedRows() should return 0");
+	g.fillRow(1, 2);
+	g.fillRow(3, 2);
+	assert(g.removeCompletedRows() == 2 && "Gameboard.removeCompletedRows() should return 2");
+	assert(isGameboardEmpty(g) == true && "Gameboard.isGameboardEmpty() should return true");
+
+	// test getRowFillCount() & getColumnHeight()
+	g.empty();
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		assert(g.getColumnHeight(x) == 0 && "Gameboard.getColumnHeight() should be 0 on an empty board");
+	}
+	g.setContent(2, Gameboard::MAX_Y - 1, 1);
+	g.setContent(2, Gameboard::MAX_Y - 4, 1);
+	g.setContent(3, Gameboard::MAX_Y - 1, 1);
+	g.setContent(3, Gameboard::MAX_Y - 1, 5);	// overwriting a block shouldn't count twice
+	assert(g.getRowFillCount(Gameboard::MAX_Y - 1) == 2 && "Gameboard.getRowFillCount() expected 2");
+	assert(g.getColumnHeight(2) == 4 && g.getColumnHeight(3) == 1 && "Gameboard.getColumnHeight() unexpected result");
+	g.setContent(2, Gameboard::MAX_Y - 4, Gameboard::EMPTY_BLOCK);	// removing the top block drops the height
+	assert(g.getColumnHeight(2) == 1 && "Gameboard.getColumnHeight() not updated when the top block was emptied");
+	g.fillRow(Gameboard::MAX_Y - 2, 1);
+	assert(g.getRowFillCount(Gameboard::MAX_Y - 2) == Gameboard::MAX_X && g.getColumnHeight(0) == 2 &&
+		"Gameboard.fillRow() did not update the fill count and heights");
+	g.removeCompletedRows();
+	assert(g.getColumnHeight(0) == 0 && g.getColumnHeight(2) == 1 && g.getColumnHeight(3) == 1 &&
+		"Gameboard.removeCompletedRows() did not update the column heights");
+
+	// only the requested rows are tested for completion
+	g.empty();
+	g.fillRow(4, 1);
+	g.fillRow(10, 1);
+	Gameboard::CompletedRows rangeRows;
+	assert(g.removeCompletedRows(8, 12, rangeRows) == 1 && rangeRows.indices[0] == 10 &&
+		"Gameboard.removeCompletedRows(first, last) should only remove rows in its range");
+	assert(g.isRowCompleted(5) && "Gameboard.removeCompletedRows(first, last) should move row 4 down to row 5");
+
+	// test removeCompletedRows() reports the removed rows
+	g.empty();
+	g.fillRow(5, 1);
+	g.fillRow(Gameboard::MAX_Y - 1, 1);
+	g.fillRow(Gameboard::MAX_Y - 2, 1);
+	g.setContent(3, Gameboard::MAX_Y - 3, 4);
+	Gameboard::CompletedRows removedRows;
+	assert(g.removeCompletedRows(removedRows) == 3 && "Gameboard.removeCompletedRows() should return 3");
+	assert(removedRows.count == 3 && removedRows.indices[0] == 5 &&
+		removedRows.indices[1] == Gameboard::MAX_Y - 2 && removedRows.indices[2] == Gameboard::MAX_Y - 1 &&
+		"Gameboard.removeCompletedRows() reported unexpected row indices");
+	assert(g.getContent(3, Gameboard::MAX_Y - 1) == 4 && g.getRowMask(Gameboard::MAX_Y - 1) == (1 << 3) &&
+		"Gameboard.removeCompletedRows() did not move the surviving row to the bottom");
+	assert(isGameboardEmpty(g) == false && g.getRowMask(Gameboard::MAX_Y - 2) == 0 &&
+		"Gameboard.removeCompletedRows() left unexpected content");
+
+	// test if a row gets moved down by removeCompletedRows()
+	g.empty();
+	g.fillRow(0, 0);
+	g.fillRow(1, 1);
+	g.fillRow(2, 2);
+	g.fillRow(3, 3);
+	g.setContent(0, 0, Gameboard::EMPTY_BLOCK);
+	g.setContent(0, 1, Gameboard::EMPTY_BLOCK);
+	g.setContent(0, 2, Gameboard::EMPTY_BLOCK);
+	// at this point row 3 is the only complete row
+	g.removeCompletedRows();
+	assert(g.getContent(1, 0) == Gameboard::EMPTY_BLOCK && "Gameboard.removeCompletedRows() first row should be empty");
+	assert(g.getContent(1, 1) == 0 && "Gameboard.removeCompletedRows() unexpected results");	// row 0 copied into row 1
+	assert(g.getContent(1, 2) == 1 && "Gameboard.removeCompletedRows() unexpected results");	// row 1 copied into row 2
+	assert(g.getContent(1, 3) == 2 && "Gameboard.removeCompletedRows() unexpected results");	// row 2 copied into row 3
+	assert(g.getContent(1, 4) == Gameboard::EMPTY_BLOCK && "Gameboard.removeCompletedRows() unexpected results");	// row 4 is still empty
+
+
+	// test areLocsEmpty()
+	g.empty();
+	g.fillRow(2, 2);
+	std::vector<Point> testPoints;
+	testPoints.push_back(Point(0, 0));
+	testPoints.push_back(Point(1, 1));
+	testPoints.push_back(Point(3, 3));
+	assert(g.areAllLocsEmpty(testPoints) == true &&
+		"Gameboard.areAllLocsEmpty() expected true but was false");  // should return true since all points are empty
+	testPoints.push_back(Point(2, 2));
+	assert(g.areAllLocsEmpty(testPoints) == false &&
+		"Gameboard.areAllLocsEmpty() expected false but was true");  // should return false since 2,2 contains content 2
+
+	// throw some invalid points at areLocsEmpty and see if it ignores them
+	g.empty();
+	std::vector<Point> invalidPoints = { Point(-3,-20), Point(200, 23), Point(-30, 150) };
+	assert(g.areAllLocsEmpty(invalidPoints) == true && "Gameboard.areAllLocsEmpty() expected true but was false");
+
+	std::vector<Point> mixedPoints1 = { Point(-3,-20), Point(200, 23), Point(6, 6), Point(5,5) };
+	assert(g.areAllLocsEmpty(mixedPoints1) == true && "Gameboard.areAllLocsEmpty() expected true but was false");
+
+	g.fillRow(3, 3);
+	std::vector<Point> mixedPoints2 = { Point(-3,-20), Point(200, 23), Point(6, 6), Point(3,3) };
+	assert(g.areAllLocsEmpty(mixedPoints2) == false && "Gameboard.areAllLocsEmpty() expected false but was true");
+
+	// lastly do a visual printout of an empty board
+	g.empty();
+	g.printToConsole();
+	std::cout << "\n";
+	// print out the board with filled in rows)
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		g.fillRow(y, y % 10);
+	}
+	g.printToConsole();
+	std::cout << "\n";
+	// print out the board with completed rows removed (should be empty)
+	g.removeCompletedRows();
+	g.printToConsole();
+
+	// ensure methods that should be const are actually const
+	// These lines will cause compile time errors if you have methods in your Gameboard class that
+	// should be labelled as const (because the methods don't change the internal member
+	// variables of yoru class).
+	// (see LearnCpp 13.2- const class objects and member functions)
+	const Gameboard g2;
+	g2.getContent(0, 0);
+	g2.getContent(Point(1, 1));
+	std::vector<Point> pts = { Point(2,2) };
+	g2.areAllLocsEmpty(pts);
+	g2.printToConsole();
+	g2.isRowCompleted(2);
+	g2.getCompletedRowIndices();
+	g2.isValidPoint(1, 1);
+	g2.isValidPoint(Point(3, 3));
+
+
+	// These methods should ignore invalid points
+	// undefined behaviour would result if they didn't.
+	Gameboard g3;
+	std::cout << "Testing gameboard.setContent() methods()...";
+	g3.setContent(-1, -1, 1);
+	g3.setContent(25, 25, 1);
+	g3.setContent(Point(-1, -1), 1);
+	g3.setContent(Point(25, 25), 1);
+	std::vector<Point> invalidPoints2{ Point(-5,-5), Point(50,50) };
+	g3.setContent(invalidPoints2, 1);
+
+
+}
+
+
+
+void TestSuite::testGridTetrominoClass()
+{
+
+	GridTetromino gt;
+
+	// check if constructor sets gridLoc to 0,0
+	assert(gt.getGridLoc().getX() == 0 && gt.getGridLoc().getY() == 0);
+
+	// test setGridLoc(x,y)
+	gt.setGridLoc(4, 5);
+	assert(gt.getGridLoc().getX() == 4 && gt.getGridLoc().getY() == 5);
+
+	// test setGridLoc(Point)
+	gt.setGridLoc(Point(8, 9));
+	assert(gt.getGridLoc().getX() == 8 && gt.getGridLoc().getY() == 9);
+
+	// test move()
+	gt.setGridLoc(1, 2);
+	gt.move(5, 5);
+	assert(gt.getGridLoc().getX() == 6 && gt.getGridLoc().getY() == 7);
+
+
+	// test getBlockLocsMappedToGrid()
+	gt.setShape(TetShape::L);
+	gt.rotateClockwise();
+	gt.setGridLoc(5, 5);
+	BlockLocs locs = gt.getBlockLocsMappedToGrid();
+	assert(locs.size() == BLOCK_COUNT);
+	assert(locs[2].getX() == 4 && locs[2].getY() == 4);	// L block [1,-1] rotates to [-1,-1]
+
+	// A const gridTetromino should be able to call the following methods
+	// (since these methods don't change the state of the class)
+	// If these stop you from compiling, it is because you haven't labelled these
+	// methods as const.
+	const GridTetromino gt2;
+	gt2.getGridLoc();
+	gt2.getBlockLocsMappedToGrid();
+
+	// a gridTetromino should still be able to access methods from the Tetromino class.
+	gt2.getColor();
+
+}
+
+
+
+void TestSuite::testTetrisSimulationClass()
+{
+
+	TetrisSimulation game;
+
+	// a new game spawns the current shape at the board's spawn location
+	assert(game.getScore() == 0 && "TetrisSimulation should start with a score of 0");
+	assert(game.getCurrentShape().getGridLoc().getX() == game.getBoard().getSpawnLoc().getX() &&
+		game.getCurrentShape().getGridLoc().getY() == game.getBoard().getSpawnLoc().getY() &&
+		"TetrisSimulation should spawn the current shape at the spawn location");
+
+	// a vertical I on an empty board
+	game.currentShape.setShape(TetShape::I);
+	game.currentShape.setGridLoc(0, 0);
+	assert(game.isPositionLegal(game.currentShape) && "TetrisSimulation.isPositionLegal() expected true");
+	assert(!game.attemptMove(game.currentShape, -1, 0) && "TetrisSimulation.attemptMove() moved through the left wall");
+	assert(game.attemptMove(game.currentShape, 1, 0) && "TetrisSimulation.attemptMove() expected to move right");
+
+	// the shape may hang above the top border, but not below the bottom
+	game.currentShape.setGridLoc(1, -3);
+	assert(game.isPositionLegal(game.currentShape) && "TetrisSimulation.isPositionLegal() should ignore the top border");
+	game.currentShape.setGridLoc(1, Gameboard::MAX_Y - 2);
+	assert(!game.isPositionLegal(game.currentShape) && "TetrisSimulation.isPositionLegal() should test the bottom border");
+
+	// drop() rests the I on the floor, lock() copies it onto the board
+	game.currentShape.setGridLoc(0, 0);
+	game.drop(game.currentShape);
+	assert(game.currentShape.getGridLoc().getY() == Gameboard::MAX_Y - 3 && "TetrisSimulation.drop() did not reach the floor");
+	game.applyInput(GameInput::HARD_DROP);
+	assert(game.getBoard().getContent(0, Gameboard::MAX_Y - 1) == static_cast<int>(game.currentShape.getColor()) &&
+		"TetrisSimulation HARD_DROP did not lock the shape onto the board");
+
+	// until the next shape spawns, inputs can't lock the locked shape again
+	assert(game.isAwaitingSpawn() && "TetrisSimulation should await a spawn after a HARD_DROP");
+	const int piecesLocked = game.getPiecesLocked();
+	const unsigned int lockedRevision = game.getBoardRevision();
+	const int lockedY = game.currentShape.getGridLoc().getY();
+	game.applyInput(GameInput::HARD_DROP);
+	game.applyInput(GameInput::SOFT_DROP);
+	game.applyInput(GameInput::LEFT);
+	assert(game.getPiecesLocked() == piecesLocked && game.getBoardRevision() == lockedRevision &&
+		"TetrisSimulation should ignore inputs while awaiting a spawn");
+	assert(game.currentShape.getGridLoc().getY() == lockedY && game.currentShape.getGridLoc().getX() == 0 &&
+		"TetrisSimulation moved a locked shape");
+	game.stepGameLoop(true);
+	assert(game.getPiecesLocked() == piecesLocked && !game.isAwaitingSpawn() &&
+		"TetrisSimulation gravity should skip a shape locked by the loop's inputs");
+
+	// getDropDistance() matches stepping the shape down one row at a time,
+	// including shapes tucked under an overhang
+	game.reset();
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		game.board.setContent(x, Gameboard::MAX_Y - 1 - (x * 7) % 5, 2);
+	}
+	game.board.fillRow(6, 3);
+	game.board.setContent(std::vector<Point>{ Point(0, 6), Point(1, 6), Point(2, 6) }, Gameboard::EMPTY_BLOCK);
+	for (int shape = 0; shape < static_cast<int>(TetShape::COUNT); shape++) {
+		for (int rotation = 0; rotation < Tetromino::ROTATION_COUNT; rotation++) {
+			for (int x = -2; x < Gameboard::MAX_X + 2; x++) {
+				for (int y = -2; y < Gameboard::MAX_Y; y++) {
+					GridTetromino stepped;
+					stepped.setShape(static_cast<TetShape>(shape));
+					for (int i = 0; i < rotation; i++) {
+						stepped.rotateClockwise();
+					}
+					stepped.setGridLoc(x, y);
+					if (!game.isPositionLegal(stepped)) {
+						continue;
+					}
+					GridTetromino dropped{ stepped };
+					while (game.attemptMove(stepped, 0, 1));
+					game.drop(dropped);
+					assert(dropped.getGridLoc().getY() == stepped.getGridLoc().getY() &&
+						"TetrisSimulation.drop() should land where stepping down lands");
+				}
+			}
+		}
+	}
+
+	// completing a row scores it on the next game loop
+	game.reset();
+	game.board.fillRow(Gameboard::MAX_Y - 1, 0);
+	game.board.fillRow(Gameboard::MAX_Y - 2, 0);
+	game.board.setContent(std::vector<Point>{ Point(0, Gameboard::MAX_Y - 1), Point(1, Gameboard::MAX_Y - 1),
+		Point(0, Gameboard::MAX_Y - 2), Point(1, Gameboard::MAX_Y - 2) }, Gameboard::EMPTY_BLOCK);
+	game.currentShape.setShape(TetShape::O);
+	game.currentShape.setGridLoc(0, Gameboard::MAX_Y - 2);
+	unsigned int revision = game.getBoardRevision();
+	game.lock(game.currentShape);
+	assert(game.getBoardRevision() != revision && "TetrisSimulation.lock() should change the board revision");
+	revision = game.getBoardRevision();
+	game.processGameLoop(0.0f);
+	assert(game.getBoardRevision() != revision && "removing rows should change the board revision");
+	assert(game.getScore() == TetrisSimulation::DOUBLE_LINE && "TetrisSimulation did not score a double");
+	assert(game.getBoard().getRowMask(Gameboard::MAX_Y - 1) == 0 && "TetrisSimulation did not clear completed rows");
+
+}
+
+
+
+void TestSuite::testPieceRandomizerClass()
+{
+
+	// the same seed and mode always deal the same shapes
+	for (int mode = 0; mode < static_cast<int>(RandomizerMode::COUNT); mode++) {
+		PieceRandomizer a{ 42, static_cast<RandomizerMode>(mode) };
+		PieceRandomizer b{ 42, static_cast<RandomizerMode>(mode) };
+		for (int i = 0; i < 100; i++) {
+			assert(a.nextShape() == b.nextShape() && "PieceRandomizer sequences with the same seed differ");
+		}
+	}
+	PieceRandomizer seeded1{ 1, RandomizerMode::RANDOM };
+	PieceRandomizer seeded2{ 2, RandomizerMode::RANDOM };
+	bool differs = false;
+	for (int i = 0; i < 20; i++) {
+		differs = differs || seeded1.nextShape() != seeded2.nextShape();
+	}
+	assert(differs && "PieceRandomizer sequences with different seeds should differ");
+
+	// every bag of 7 deals each shape exactly once
+	PieceRandomizer bag{ 7, RandomizerMode::BAG };
+	for (int bagCount = 0; bagCount < 10; bagCount++) {
+		int dealt[PieceRandomizer::SHAPE_COUNT] = {};
+		for (int i = 0; i < PieceRandomizer::SHAPE_COUNT; i++) {
+			dealt[static_cast<int>(bag.nextShape())]++;
+		}
+		for (int count : dealt) {
+			assert(count == 1 && "PieceRandomizer BAG mode should deal each shape once per bag");
+		}
+	}
+
+	// history mode rarely repeats a recent shape
+	PieceRandomizer history{ 3, RandomizerMode::HISTORY };
+	int repeats = 0;
+	TetShape previous = history.nextShape();
+	for (int i = 0; i < 1000; i++) {
+		TetShape shape = history.nextShape();
+		repeats += (shape == previous) ? 1 : 0;
+		previous = shape;
+	}
+	assert(repeats < 50 && "PieceRandomizer HISTORY mode repeats too often");
+
+	// a saved state continues the exact same sequence
+	PieceRandomizer original{ 99, RandomizerMode::BAG };
+	for (int i = 0; i < 10; i++) {
+		original.nextShape();
+	}
+	std::stringstream saved;
+	original.writeState(saved);
+	assert(saved.str().size() == PieceRandomizer::SERIALIZED_SIZE && "PieceRandomizer.writeState() unexpected size");
+	PieceRandomizer restored{ 1, RandomizerMode::RANDOM };
+	assert(restored.readState(saved) && "PieceRandomizer.readState() failed");
+	for (int i = 0; i < 50; i++) {
+		assert(original.nextShape() == restored.nextShape() && "PieceRandomizer restored state diverged");
+	}
+	std::stringstream truncated{ std::string("\x01\x02") };
+	assert(!restored.readState(truncated) && "PieceRandomizer.readState() accepted a truncated state");
+
+}
+
+
+
+void TestSuite::testPlacementGeneratorClass()
+{
+
+	Gameboard g;
+	PlacementGenerator::PlacementList list;
+
+	// on an empty board: one placement per column each distinct rotation fits in
+	assert(PlacementGenerator::generate(g, TetShape::T, list) == 8 + 9 + 8 + 9 && "PlacementGenerator T count");
+	assert(PlacementGenerator::generate(g, TetShape::O, list) == 9 && "PlacementGenerator O count");
+	assert(PlacementGenerator::generate(g, TetShape::I, list) == 10 + 7 && "PlacementGenerator I count");
+	assert(PlacementGenerator::generate(g, TetShape::S, list) == 8 + 9 && "PlacementGenerator S count");
+	assert(PlacementGenerator::generate(g, TetShape::Z, list) == 8 + 9 && "PlacementGenerator Z count");
+
+	// every placement is legal and resting on something
+	g.fillRow(Gameboard::MAX_Y - 1, 1);
+	g.setContent(4, Gameboard::MAX_Y - 1, Gameboard::EMPTY_BLOCK);
+	g.setContent(0, Gameboard::MAX_Y - 2, 1);
+	g.setContent(0, Gameboard::MAX_Y - 3, 1);
+	for (int shape = 0; shape < static_cast<int>(TetShape::COUNT); shape++) {
+		PlacementGenerator::generate(g, static_cast<TetShape>(shape), list);
+		assert(list.count > 0 && "PlacementGenerator found no placements");
+		for (int i = 0; i < list.count; i++) {
+			GridTetromino placed = PlacementGenerator::toGridTetromino(static_cast<TetShape>(shape), list.placements[i]);
+			assert(TetrisSimulation::isPositionLegal(g, placed) && "PlacementGenerator produced an illegal placement");
+			placed.move(0, 1);
+			assert(!TetrisSimulation::isPositionLegal(g, placed) && "PlacementGenerator produced a floating placement");
+		}
+	}
+
+}
+
+
+void TestSuite::testReachabilitySearchClass()
+{
+
+	Gameboard g;
+	ReachabilitySearch search;
+	PlacementGenerator::PlacementList list;
+
+	// on an empty board every hard drop placement is reachable (and nothing more)
+	for (int shape = 0; shape < static_cast<int>(TetShape::COUNT); shape++) {
+		assert(search.search(g, static_cast<TetShape>(shape)) == PlacementGenerator::generate(g, static_cast<TetShape>(shape), list)
+			&& "ReachabilitySearch should match hard drops on an empty board");
+	}
+
+	// a ledge over columns 0-6 leaves a cave underneath that can only be
+	// reached by soft dropping down columns 7-9 and sliding in
+	const int ledgeRow = Gameboard::MAX_Y - 4;
+	for (int x = 0; x <= 6; x++) {
+		g.setContent(x, ledgeRow, 1);
+	}
+	GameInput path[ReachabilitySearch::STATE_COUNT];
+	for (int shape = 0; shape < static_cast<int>(TetShape::COUNT); shape++) {
+		const TetShape tetShape = static_cast<TetShape>(shape);
+		const int generated = PlacementGenerator::generate(g, tetShape, list);
+		const int found = search.search(g, tetShape);
+		assert(found > generated && "ReachabilitySearch missed the tucks under the ledge");
+
+		bool foundTuck = false;
+		for (int i = 0; i < found; i++) {
+			GridTetromino placed = PlacementGenerator::toGridTetromino(tetShape, search.getResult(i));
+			assert(TetrisSimulation::isPositionLegal(g, placed) && "ReachabilitySearch produced an illegal position");
+			GridTetromino below{ placed };
+			below.move(0, 1);
+			assert(!TetrisSimulation::isPositionLegal(g, below) && "ReachabilitySearch produced a floating position");
+
+			bool underLedge = false;
+			for (const Point& p : placed.getBlockLocsMappedToGrid()) {
+				underLedge = underLedge || (p.getX() <= 6 && p.getY() > ledgeRow);
+			}
+			if (!underLedge) {
+				continue;
+			}
+			foundTuck = true;
+
+			// replaying the path with the real controls locks the piece right there
+			const int length = search.getPath(i, path, ReachabilitySearch::STATE_COUNT);
+			assert(length > 1 && path[length - 1] == GameInput::HARD_DROP && "ReachabilitySearch path should end in a HARD_DROP");
+			TetrisSimulation game;
+			for (int x = 0; x <= 6; x++) {
+				game.board.setContent(x, ledgeRow, 1);
+			}
+			game.currentShape.setShape(tetShape);
+			game.currentShape.setGridLoc(g.getSpawnLoc());
+			for (int step = 0; step < length - 1; step++) {
+				game.applyInput(path[step]);
+			}
+			game.currentShape.move(0, game.getDropDistance(game.currentShape));
+			assert(game.currentShape.getGridLoc().getX() == placed.getGridLoc().getX()
+				&& game.currentShape.getGridLoc().getY() == placed.getGridLoc().getY()
+				&& game.currentShape.getRotation() == placed.getRotation() && "ReachabilitySearch path doesn't reach its position");
+			game.applyInput(path[length - 1]);
+			for (const Point& p : placed.getBlockLocsMappedToGrid()) {
+				assert(game.board.getContent(p) != Gameboard::EMPTY_BLOCK && "ReachabilitySearch path didn't lock there");
+			}
+		}
+		assert(foundTuck && "ReachabilitySearch found no position under the ledge");
+	}
+
+}
+
+
+void TestSuite::testTaskPoolClass()
+{
+
+	// every index runs exactly once, whatever the worker count (0 runs inline)
+	const int count = 1000;		// more than the queues hold, the caller runs the overflow
+	for (unsigned int workerCount : { 0u, 1u, 3u }) {
+		TaskPool pool(workerCount);
+		assert(pool.getWorkerCount() == workerCount && "TaskPool::getWorkerCount()");
+		for (int run = 0; run < 3; run++) {
+			std::atomic<int> calls[count];
+			for (std::atomic<int>& c : calls) {
+				c = 0;
+			}
+			auto task = [&](int index) { calls[index]++; };
+			pool.parallelFor(count, task);
+			for (const std::atomic<int>& c : calls) {
+				assert(c == 1 && "TaskPool::parallelFor() should run every index once");
+			}
+		}
+		int none = 0;
+		auto nothing = [&](int) { none++; };
+		pool.parallelFor(0, nothing);
+		assert(none == 0 && "TaskPool::parallelFor(0) ran something");
+	}
+
+}
+
+
+
+void TestSuite::testTickSchedulerClass()
+{
+	using std::chrono::milliseconds;
+
+	// whole steps are returned, the remainder carries over to the next advance()
+	TickScheduler scheduler(milliseconds(10), 25);
+	assert(scheduler.advance(milliseconds(25)) == 2 && "TickScheduler::advance() should return the whole steps owed");
+	assert(scheduler.getPendingTime() == milliseconds(5) && "TickScheduler::getPendingTime() should hold the remainder");
+	assert(scheduler.getTimeUntilNextStep() == milliseconds(5) && "TickScheduler::getTimeUntilNextStep()");
+	assert(scheduler.getTimeUntilSteps(3) == milliseconds(25) && "TickScheduler::getTimeUntilSteps()");
+	assert(scheduler.advance(milliseconds(5)) == 1 && "TickScheduler::advance() should carry the remainder over");
+	assert(scheduler.advance(milliseconds(-40)) == 0 && "TickScheduler::advance() should ignore negative time");
+	assert(scheduler.getStepCount() == 3 && scheduler.getDropCount() == 0 && "TickScheduler step/drop counts");
+
+	// a stall runs at most maxSteps, the rest is dropped and counted
+	assert(scheduler.advance(milliseconds(1004)) == 25 && "TickScheduler::advance() should cap the steps");
+	assert(scheduler.getDroppedTime() == milliseconds(750) && scheduler.getDropCount() == 1 &&
+		"TickScheduler should count the dropped time");
+	assert(scheduler.getPendingTime() == milliseconds(4) && "TickScheduler should keep the part step after a drop");
+	scheduler.clearPending();
+	assert(scheduler.advance(milliseconds(9)) == 0 && "TickScheduler::clearPending()");
+
+	// gravity ticks once the tick length has passed, not before
+	TetrisSimulation game;
+	const int startY = game.getCurrentShape().getGridLoc().getY();
+	game.processGameLoop(game.getTickLength() - milliseconds(10));
+	assert(game.getCurrentShape().getGridLoc().getY() == startY && "TetrisSimulation ticked early");
+	assert(game.getTimeUntilTick() == milliseconds(10) && "TetrisSimulation::getTimeUntilTick()");
+	game.processGameLoop(milliseconds(10));
+	assert(game.getCurrentShape().getGridLoc().getY() == startY + 1 && "TetrisSimulation didn't tick on time");
+
+	// the frame rate doesn't change the game: 7 ms & 33 ms frames over the same
+	// 23.1 seconds run the same steps & gravity ticks
+	TetrisSimulation fastGame(11, RandomizerMode::BAG);
+	TetrisSimulation slowGame(11, RandomizerMode::BAG);
+	TickScheduler fastScheduler;
+	TickScheduler slowScheduler;
+	for (int frame = 0; frame < 3300; frame++) {
+		for (int steps = fastScheduler.advance(milliseconds(7)); steps > 0; steps--) {
+			fastGame.processGameLoop(fastScheduler.getStepLength());
+		}
+	}
+	for (int frame = 0; frame < 700; frame++) {
+		for (int steps = slowScheduler.advance(milliseconds(33)); steps > 0; steps--) {
+			slowGame.processGameLoop(slowScheduler.getStepLength());
+		}
+	}
+	assert(fastGame.getLoopCount() == 2310 && slowGame.getLoopCount() == 2310 && "TickScheduler steps depend on the frame rate");
+	assert(fastGame.getPiecesLocked() > 0 && fastGame.getPiecesLocked() == slowGame.getPiecesLocked() &&
+		fastGame.getBoard().getContentHash() == slowGame.getBoard().getContentHash() &&
+		fastGame.getCurrentShape().getGridLoc().getY() == slowGame.getCurrentShape().getGridLoc().getY() &&
+		"TetrisSimulation gravity depends on the frame rate");
+
+}
+
+
+void TestSuite::testInputStageClass()
+{
+	using std::chrono::milliseconds;
+	const InputStage::Clock::time_point start = InputStage::Clock::now();
+
+	// inputs are applied oldest first, only once their arrival time is reached
+	TetrisSimulation game;
+	const int startX = game.getCurrentShape().getGridLoc().getX();
+	InputStage stage;
+	assert(stage.push(GameInput::LEFT, start) && stage.push(GameInput::LEFT, start + milliseconds(5)) &&
+		stage.push(GameInput::RIGHT, start + milliseconds(20)) && "InputStage::push() failed");
+	assert(stage.getQueuedCount() == 3 && "InputStage::getQueuedCount()");
+	assert(stage.applyUntil(game, start - milliseconds(1), start) == 0 && "InputStage applied an input early");
+	assert(stage.applyUntil(game, start + milliseconds(10), start + milliseconds(10)) == 2 &&
+		game.getCurrentShape().getGridLoc().getX() == startX - 2 && "InputStage::applyUntil() should apply inputs that arrived");
+	assert(stage.applyUntil(game, start + milliseconds(30), start + milliseconds(30)) == 1 &&
+		game.getCurrentShape().getGridLoc().getX() == startX - 1 && stage.getQueuedCount() == 0 &&
+		"InputStage::applyUntil() should apply the rest in order");
+
+	// latency is measured from arrival to when the input reached the board
+	assert(stage.getLatencyCount() == 3 && "InputStage::getLatencyCount()");
+	assert(stage.getMaxLatency() == milliseconds(10) && stage.getLastLatency() == milliseconds(10) &&
+		stage.getMeanLatency() == std::chrono::nanoseconds(milliseconds(25)) / 3 && "InputStage latency statistics");
+	stage.resetLatencyStats();
+	assert(stage.getLatencyCount() == 0 && stage.getMeanLatency().count() == 0 && "InputStage::resetLatencyStats()");
+
+	// a full queue drops inputs (and counts them) rather than growing
+	for (int i = 0; i < InputStage::CAPACITY; i++) {
+		assert(stage.push(GameInput::ROTATE, start) && "InputStage::push() failed before the queue was full");
+	}
+	assert(!stage.push(GameInput::ROTATE, start) && stage.getDroppedCount() == 1 && "InputStage should drop inputs when full");
+	stage.clear();
+	assert(stage.getQueuedCount() == 0 && stage.applyUntil(game, start, start) == 0 && "InputStage::clear()");
+
+}
+
+
+void TestSuite::testAutoShiftClass()
+{
+	using std::chrono::milliseconds;
+
+	// getShiftDistance() matches stepping the shape a column at a time, for every shape & rotation
+	TetrisSimulation game;
+	for (int x = 0; x < Gameboard::MAX_X; x++) {
+		game.board.setContent(x, Gameboard::MAX_Y - 1 - (x * 3) % 7, 4);
+	}
+	game.board.setContent(std::vector<Point>{ Point(1, 9), Point(8, 12) }, 5);
+	for (int shape = 0; shape < static_cast<int>(TetShape::COUNT); shape++) {
+		for (int rotation = 0; rotation < Tetromino::ROTATION_COUNT; rotation++) {
+			for (int y = -1; y < Gameboard::MAX_Y; y++) {
+				for (int x = -1; x <= Gameboard::MAX_X; x++) {
+					GridTetromino piece;
+					piece.setShape(static_cast<TetShape>(shape));
+					for (int r = 0; r < rotation; r++) {
+						piece.rotateClockwise();
+					}
+					piece.setGridLoc(x, y);
+					if (!game.isPositionLegal(piece)) {
+						continue;
+					}
+					for (int direction : { -1, 1 }) {
+						GridTetromino stepped{ piece };
+						int expected = 0;
+						while (game.attemptMove(stepped, direction, 0)) {
+							expected++;
+						}
+						assert(game.getShiftDistance(piece, direction) == expected &&
+							"TetrisSimulation::getShiftDistance() doesn't match stepping the shape");
+					}
+				}
+			}
+		}
+	}
+
+	// holding a direction repeats after DAS, every ARR, until it's released
+	game.reset();
+	const int startX = game.getCurrentShape().getGridLoc().getX();
+	const AutoShift::Clock::time_point start = AutoShift::Clock::now();
+	AutoShift shift(milliseconds(100), milliseconds(20));
+	shift.press(-1, start);
+	assert(shift.applyUntil(game, start + milliseconds(99)) == 0 && shift.getDirection() == -1 && "AutoShift repeated before DAS");
+	assert(shift.applyUntil(game, start + milliseconds(100)) == 1 && "AutoShift didn't repeat at DAS");
+	assert(shift.applyUntil(game, start + milliseconds(145)) == 2 && "AutoShift didn't repeat every ARR");
+	shift.release(-1, start + milliseconds(150));
+	assert(shift.applyUntil(game, start + milliseconds(500)) == 0 && shift.getDirection() == 0 && "AutoShift repeated after release");
+	assert(game.getCurrentShape().getGridLoc().getX() == startX - 3 && "AutoShift moved the shape the wrong distance");
+
+	// the last direction pressed wins, releasing it charges the other from the release
+	shift.press(-1, start + milliseconds(600));
+	shift.press(1, start + milliseconds(650));
+	assert(shift.applyUntil(game, start + milliseconds(720)) == 0 && shift.getDirection() == 1 && "AutoShift should take the newest direction");
+	assert(shift.applyUntil(game, start + milliseconds(750)) == 1 && game.getCurrentShape().getGridLoc().getX() == startX - 2 &&
+		"AutoShift should repeat the newest direction");
+	shift.release(1, start + milliseconds(760));
+	assert(shift.applyUntil(game, start + milliseconds(859)) == 0 && shift.getDirection() == -1 && "AutoShift should fall back to the held direction");
+	assert(shift.applyUntil(game, start + milliseconds(860)) == 1 && "AutoShift should charge the held direction from the release");
+	shift.clear();
+	assert(shift.getDirection() == 0 && shift.applyUntil(game, start + milliseconds(2000)) == 0 && "AutoShift::clear()");
+
+	// ARR 0 goes straight to the wall at DAS, in one move
+	AutoShift instant(milliseconds(100), milliseconds(0));
+	instant.press(1, start);
+	assert(instant.applyUntil(game, start + milliseconds(50)) == 0 && "AutoShift ARR 0 moved before DAS");
+	const int toWall = game.getShiftDistance(game.getCurrentShape(), 1);
+	assert(toWall > 0 && instant.applyUntil(game, start + milliseconds(100)) == toWall &&
+		game.getShiftDistance(game.getCurrentShape(), 1) == 0 && "AutoShift ARR 0 should shift to the wall");
+	game.currentShape.move(-2, 0);
+	assert(instant.applyUntil(game, start + milliseconds(110)) == 2 && "AutoShift ARR 0 should keep the shape at the wall");
+
+}
+
+
+void TestSuite::testSpscQueueClass()
+{
+
+	// fills up, then empties in order
+	SpscQueue<int, 4> queue;
+	int item = -1;
+	assert(queue.isEmpty() && !queue.pop(item) && "SpscQueue should start empty");
+	for (int i = 0; i < 4; i++) {
+		assert(queue.push(i) && "SpscQueue::push() failed before the queue was full");
+	}
+	assert(!queue.push(4) && "SpscQueue::push() should fail when full");
+	for (int i = 0; i < 4; i++) {
+		assert(queue.pop(item) && item == i && "SpscQueue::pop() should return items in order");
+	}
+	assert(queue.isEmpty() && "SpscQueue should be empty after popping everything");
+
+	// one thread pushing while another pops: every item arrives once, in order
+	const int count = 200000;
+	SpscQueue<int, 64> handoff;
+	std::thread producer([&handoff]() {
+		for (int i = 0; i < count; i++) {
+			while (!handoff.push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	int expected = 0;
+	while (expected < count) {
+		if (!handoff.pop(item)) {
+			std::this_thread::yield();
+			continue;
+		}
+		assert(item == expected && "SpscQueue lost or reordered an item between threads");
+		expected++;
+	}
+	producer.join();
+	assert(handoff.isEmpty() && "SpscQueue should be empty once everything's popped");
+
+}
+
+
+void TestSuite::testTripleBufferClass()
+{
+
+	// the reader sees nothing new until a publish, then the newest value
+	TripleBuffer<int> buffer;
+	assert(!buffer.update() && "TripleBuffer::update() with nothing published");
+	buffer.getWriteBuffer() = 1;
+	buffer.publish();
+	buffer.getWriteBuffer() = 2;
+	buffer.publish();
+	assert(buffer.update() && buffer.getReadBuffer() == 2 && "TripleBuffer should hand over the newest value");
+	assert(!buffer.update() && buffer.getReadBuffer() == 2 && "TripleBuffer::update() with nothing new");
+
+	// one thread publishing while another reads: values only move forward, and the last one arrives
+	struct Pair { int a; int b; };
+	TripleBuffer<Pair> pairs;
+	const int count = 200000;
+	std::thread writer([&pairs]() {
+		for (int i = 1; i <= count; i++) {
+			pairs.getWriteBuffer() = Pair{ i, -i };
+			pairs.publish();
+		}
+	});
+	int last = 0;
+	while (last < count) {
+		if (!pairs.update()) {
+			std::this_thread::yield();
+			continue;
+		}
+		const Pair& pair = pairs.getReadBuffer();
+		assert(pair.a == -pair.b && "TripleBuffer handed over a half written value");
+		assert(pair.a > last && "TripleBuffer handed over an older value");
+		last = pair.a;
+	}
+	writer.join();
+
+	// a GameSnapshot captures what the renderer needs
+	TetrisSimulation game;
+	game.applyInput(GameInput::HARD_DROP);
+	game.processGameLoop(0.0f);
+	TripleBuffer<GameSnapshot> snapshots;
+	snapshots.getWriteBuffer().capture(game, 1);
+	snapshots.publish();
+	assert(snapshots.update() && "TripleBuffer<GameSnapshot> publish");
+	const GameSnapshot& snapshot = snapshots.getReadBuffer();
+	assert(snapshot.revision == 1 && snapshot.boardRevision == game.getBoardRevision() && snapshot.score == game.getScore() &&
+		"GameSnapshot::capture() revisions & score");
+	for (int y = 0; y < Gameboard::MAX_Y; y++) {
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			assert(snapshot.cells[y][x] == game.getBoard().getContent(x, y) && "GameSnapshot::capture() board");
+		}
+	}
+	assert(snapshot.currentShape.getGridLoc().getY() == game.getCurrentShape().getGridLoc().getY() &&
+		snapshot.nextShape.getShape() == game.getNextShape().getShape() &&
+		snapshot.ghostShape.getGridLoc().getY() == game.getCurrentShape().getGridLoc().getY() + game.getDropDistance(game.getCurrentShape()) &&
+		"GameSnapshot::capture() shapes");
+
+	// isCurrent() spots the changes that need a new snapshot, and only those
+	assert(snapshot.isCurrent(game) && "GameSnapshot::isCurrent() right after capture()");
+	game.processGameLoop(std::chrono::milliseconds(10));
+	assert(snapshot.isCurrent(game) && "GameSnapshot::isCurrent() should ignore steps that change nothing visible");
+	game.applyInput(GameInput::ROTATE);
+	assert(!snapshot.isCurrent(game) && "GameSnapshot::isCurrent() should see the shape rotate");
+	assert(!GameSnapshot().isCurrent(game) && "GameSnapshot::isCurrent() on a snapshot never captured");
+
+}
+
+
+void TestSuite::testWakeSignalClass()
+{
+	using std::chrono::milliseconds;
+
+	// a notify() is kept until a wait() takes it, however many there were
+	WakeSignal signal;
+	assert(!signal.wait(milliseconds(1)) && "WakeSignal::wait() with nothing notified");
+	signal.notify();
+	signal.notify();
+	assert(signal.wait(std::chrono::seconds(5)) && "WakeSignal::wait() after notify()");
+	assert(!signal.wait(milliseconds(1)) && "WakeSignal::wait() should take the notification");
+	assert(!signal.wait(-milliseconds(1)) && "WakeSignal::wait() with a timeout already passed");
+
+	// another thread's notify() wakes a thread waiting with no timeout
+	//   (elsewhere than Windows the wait also ends every FALLBACK_POLL_INTERVAL, hence the loop)
+	std::atomic<bool> woken{ false };
+	std::thread waiter([&signal, &woken]() {
+		while (!signal.wait(std::chrono::nanoseconds::max())) {
+		}
+		woken = true;
+	});
+	std::this_thread::sleep_for(milliseconds(5));
+	signal.notify();
+	waiter.join();
+	assert(woken && "WakeSignal::notify() from another thread");
+	assert(!signal.wait(milliseconds(1)) && "WakeSignal::wait() should take a notification once");
+
+}
+
+
+void TestSuite::testFrameProfilerClass()
+{
+	using std::chrono::microseconds;
+	using std::chrono::milliseconds;
+	using std::chrono::nanoseconds;
+
+	// short durations are counted exactly, longer ones to within 1/16th
+	TimingHistogram histogram;
+	assert(histogram.getCount() == 0 && histogram.getPercentile(50) == nanoseconds(0) && "TimingHistogram should start empty");
+	for (int i = 0; i < 10; i++) {
+		histogram.record(nanoseconds(i));
+	}
+	assert(histogram.getPercentile(50) == nanoseconds(4) && "TimingHistogram p50 of 0-9 ns");
+	assert(histogram.getPercentile(100) == nanoseconds(9) && histogram.getMax() == nanoseconds(9) && "TimingHistogram max");
+	histogram.record(nanoseconds(-5));
+	assert(histogram.getPercentile(0) == nanoseconds(0) && histogram.getCount() == 11 && "TimingHistogram should count negatives as 0");
+
+	histogram.clear();
+	for (int i = 1; i <= 1000; i++) {
+		histogram.record(microseconds(i));
+	}
+	const nanoseconds p50 = histogram.getPercentile(50);
+	const nanoseconds p99 = histogram.getPercentile(99);
+	assert(p50 >= microseconds(500) && p50 <= nanoseconds(microseconds(500)) * 17 / 16 && "TimingHistogram p50 accuracy");
+	assert(p99 >= microseconds(990) && p99 <= nanoseconds(microseconds(990)) * 17 / 16 && "TimingHistogram p99 accuracy");
+	assert(histogram.getMax() == microseconds(1000) && histogram.getPercentile(100) == microseconds(1000) &&
+		"TimingHistogram max should be exact");
+	assert(histogram.getMean() == nanoseconds(500500) && "TimingHistogram::getMean()");
+
+	// very long durations go in the last bucket, keeping their exact max
+	TimingHistogram longHistogram;
+	longHistogram.record(std::chrono::hours(10));
+	assert(longHistogram.getPercentile(50) == std::chrono::hours(10) && "TimingHistogram should clamp to the max");
+	longHistogram.add(histogram);
+	assert(longHistogram.getCount() == 1001 && longHistogram.getMax() == std::chrono::hours(10) && "TimingHistogram::add()");
+	assert(longHistogram.getPercentile(50) == p50 && "TimingHistogram::add() should merge the buckets");
+
+	// the rolling window keeps the last WINDOW to 2 * WINDOW, the total keeps everything
+	FrameProfiler profiler;
+	const int draw = profiler.addSection("draw");
+	const int display = profiler.addSection("display");
+	assert(profiler.getSectionCount() == 2 && profiler.getSectionName(display) == "display" && "FrameProfiler::addSection()");
+	const FrameProfiler::Clock::time_point start = FrameProfiler::Clock::now();
+	for (int i = 0; i < 100; i++) {
+		profiler.record(draw, milliseconds(2), start + milliseconds(i));
+	}
+	profiler.record(draw, milliseconds(30), start + FrameProfiler::WINDOW + milliseconds(100));
+	FrameProfiler::Stats recent = profiler.getRecentStats(draw, start + FrameProfiler::WINDOW + milliseconds(200));
+	assert(recent.count == 101 && recent.max == milliseconds(30) && recent.p50 <= nanoseconds(milliseconds(2)) * 17 / 16 &&
+		"FrameProfiler should keep the previous window half");
+	recent = profiler.getRecentStats(draw, start + 2 * FrameProfiler::WINDOW + milliseconds(200));
+	assert(recent.count == 1 && recent.p50 == milliseconds(30) && "FrameProfiler should drop the oldest window half");
+	recent = profiler.getRecentStats(draw, start + 5 * FrameProfiler::WINDOW);
+	assert(recent.count == 0 && recent.max == nanoseconds(0) && "FrameProfiler should drop windows with nothing recorded");
+	const FrameProfiler::Stats total = profiler.getTotalStats(draw);
+	assert(total.count == 101 && total.max == milliseconds(30) && "FrameProfiler::getTotalStats() should keep the whole run");
+	assert(profiler.getTotalStats(display).count == 0 && "FrameProfiler sections should be separate");
+
+	// a ScopedTimer records its scope once (and nothing without a profiler)
+	{
+		FrameProfiler::ScopedTimer timer(&profiler, display);
+		FrameProfiler::ScopedTimer offTimer(nullptr, display);
+	}
+	assert(profiler.getTotalStats(display).count == 1 && "FrameProfiler::ScopedTimer should record one duration");
+
+	std::ostringstream report;
+	profiler.writeReport(report, FrameProfiler::Clock::now());
+	assert(report.str().find("draw") != std::string::npos && report.str().find("display") != std::string::npos &&
+		"FrameProfiler::writeReport() should list every section");
+}
+
+void TestSuite::testTetrisBotClass()
+{
+
+	// features: column 0 is 3 high with 2 holes under its top, column 1 is 1 high
+	Gameboard g;
+	g.setContent(0, Gameboard::MAX_Y - 3, 1);
+	g.setContent(1, Gameboard::MAX_Y - 1, 1);
+	double features[TetrisBot::FEATURE_COUNT];
+	TetrisBot::getFeatures(g, 2, features);
+	assert(features[TetrisBot::AGGREGATE_HEIGHT] == 4 && "TetrisBot aggregate height");
+	assert(features[TetrisBot::COMPLETED_LINES] == 2 && "TetrisBot completed lines");
+	assert(features[TetrisBot::HOLES] == 2 && "TetrisBot holes");
+	assert(features[TetrisBot::BUMPINESS] == 2 + 1 && "TetrisBot bumpiness");
+	assert(features[TetrisBot::WELLS] == 0 && "TetrisBot wells (column 2 is only bounded by 1)");
+	g.setContent(3, Gameboard::MAX_Y - 2, 1);
+	TetrisBot::getFeatures(g, 0, features);
+	assert(features[TetrisBot::WELLS] == 1 && "TetrisBot wells");
+
+	// the bot plays a seeded game, threaded and not, to the same result
+	TaskPool pool(3);
+	TetrisBot threadedBot(&pool);
+	TetrisBot bot;
+	TetrisSimulation threadedGame(42);
+	TetrisSimulation game(42);
+	GameInput threadedPlan[TetrisBot::MAX_PLAN_LENGTH];
+	GameInput plan[TetrisBot::MAX_PLAN_LENGTH];
+	for (int piece = 0; piece < 100; piece++) {
+		const int length = bot.plan(game, plan, TetrisBot::MAX_PLAN_LENGTH);
+		assert(length > 0 && threadedBot.plan(threadedGame, threadedPlan, TetrisBot::MAX_PLAN_LENGTH) == length
+			&& std::equal(plan, plan + length, threadedPlan) && "TetrisBot plans differ with threads");
+		assert(threadedBot.play(threadedGame) && bot.play(game) && "TetrisBot::play() placed nothing");
+		assert(!bot.play(game) && "TetrisBot::play() should wait for the next spawn");
+		game.processGameLoop(0.0f);
+		threadedGame.processGameLoop(0.0f);
+		for (int x = 0; x < Gameboard::MAX_X; x++) {
+			assert(game.getBoard().getColumnHeight(x) < Gameboard::MAX_Y - 4 && "TetrisBot stacked too high");
+		}
+	}
+	assert(game.getScore() >= 25 * TetrisSimulation::SINGLE_LINE && "TetrisBot cleared too few lines");
+	assert(game.getPiecesLocked() == 100 && game.getLinesCleared() >= 25 && game.getGamesLost() == 0
+		&& "TetrisSimulation statistics don't match the bot's game");
+
+}
+
+
+void TestSuite::testReplayClasses()
+{
+
+	// varints round trip, and running out of data mid varint is caught
+	std::uint8_t bytes[ReplayFormat::MAX_VARINT_SIZE];
+	for (std::uint64_t value : { 0ull, 1ull, 127ull, 128ull, 300ull, 0xFFFFFFFFFFFFFFFFull }) {
+		const int size = ReplayFormat::writeVarint(value, bytes);
+		const std::uint8_t* position = bytes;
+		std::uint64_t decoded = 0;
+		assert(ReplayFormat::readVarint(position, bytes + size, decoded) && decoded == value && position == bytes + size
+			&& "ReplayFormat varint round trip");
+		position = bytes;
+		assert((size == 1 || !ReplayFormat::readVarint(position, bytes + size - 1, decoded)) && "ReplayFormat truncated varint");
+	}
+
+	// record a game with keyboard style inputs, bot moves and uneven frame times
+	const std::string path{ "testsuite.replay" };
+	TetrisSimulation game;
+	ReplayRecorder recorder;
+	game.newGame(99, RandomizerMode::HISTORY);
+	assert(recorder.open(path, 99, RandomizerMode::HISTORY) && "ReplayRecorder::open() failed");
+	recorder.setKeyframeInterval(128);
+	game.setRecorder(&recorder);
+	TetrisBot bot;
+	const float frameTimes[] = { 0.016f, 0.033f, 0.1f, 0.8f };
+	unsigned int noise = 12345;
+	const unsigned long long seekLoops[] = { 0, 1, 127, 128, 129, 1000, 2561, 4999 };
+	std::vector<std::vector<std::uint8_t>> seekStates;
+	for (int loop = 0; loop < 5000; loop++) {
+		if (std::find(std::begin(seekLoops), std::end(seekLoops), loop) != std::end(seekLoops)) {
+			TetrisSimulation::State state;
+			game.saveState(state);
+			std::uint8_t encoded[ReplayFormat::MAX_KEYFRAME_SIZE];
+			seekStates.emplace_back(encoded, encoded + ReplayFormat::writeKeyframe(state, encoded));
+		}
+		noise = noise * 1103515245u + 12345u;
+		if ((noise >> 16) % 40 == 0) {
+			bot.play(game);
+		}
+		else if ((noise >> 16) % 3 == 0) {
+			game.applyInput(static_cast<GameInput>((noise >> 20) % static_cast<int>(GameInput::COUNT)));
+		}
+		game.processGameLoop(frameTimes[(noise >> 24) % 4]);
+	}
+	game.applyInput(GameInput::LEFT);	// pending in a loop that never ran
+	game.setRecorder(nullptr);
+	assert(recorder.finish(game) && !recorder.isOpen() && "ReplayRecorder::finish() failed");
+	assert(game.getPiecesLocked() + game.getGamesLost() > 0 && "Replay test game placed nothing");
+
+	// it plays back to the same score & board
+	ReplayPlayer player;
+	TetrisSimulation replayed;
+	assert(player.load(path) && player.getSeed() == 99 && player.getMode() == RandomizerMode::HISTORY && "ReplayPlayer::load() failed");
+	assert(player.play(replayed) == ReplayPlayer::Result::OK && "ReplayPlayer::play() didn't reproduce the game");
+	assert(replayed.getScore() == game.getScore() && replayed.getLoopCount() == game.getLoopCount()
+		&& replayed.getBoard().getContentHash() == game.getBoard().getContentHash() && "ReplayPlayer end state differs");
+	assert(player.play(replayed) == ReplayPlayer::Result::OK && "ReplayPlayer::play() can't be repeated");
+
+	// seeking lands on the same state the game had at the start of that loop
+	unsigned long long keyframeLoop = 0;
+	std::size_t keyframeOffset = 0;
+	{
+		std::ifstream in(path, std::ios::binary);
+		const std::vector<std::uint8_t> bytes{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+		assert(ReplayFormat::findKeyframe(bytes.data(), bytes.size(), 300, keyframeLoop, keyframeOffset) && keyframeLoop == 256
+			&& "ReplayFormat::findKeyframe() picked the wrong keyframe");
+		assert(!ReplayFormat::findKeyframe(bytes.data(), bytes.size(), 127, keyframeLoop, keyframeOffset)
+			&& "ReplayFormat::findKeyframe() found a keyframe before the first one");
+	}
+	for (std::size_t i = 0; i < seekStates.size(); i++) {
+		assert(player.seek(replayed, seekLoops[i]) == ReplayPlayer::Result::OK && replayed.getLoopCount() == seekLoops[i]
+			&& "ReplayPlayer::seek() failed");
+		TetrisSimulation::State state;
+		replayed.saveState(state);
+		std::uint8_t encoded[ReplayFormat::MAX_KEYFRAME_SIZE];
+		const int size = ReplayFormat::writeKeyframe(state, encoded);
+		assert(std::vector<std::uint8_t>(encoded, encoded + size) == seekStates[i] && "ReplayPlayer::seek() landed on a different state");
+	}
+	assert(player.seek(replayed, 1000000) == ReplayPlayer::Result::OK && replayed.getScore() == game.getScore()
+		&& "ReplayPlayer::seek() past the end should stop at the end");
+
+	// damaged replays are reported
+	std::vector<std::uint8_t> file;
+	{
+		std::ifstream in(path, std::ios::binary);
+		file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	std::remove(path.c_str());
+	assert(player.load(file.data(), file.size() / 2) && player.play(replayed) == ReplayPlayer::Result::TRUNCATED
+		&& "ReplayPlayer missed a truncated replay");
+	std::vector<std::uint8_t> badMagic{ file };
+	badMagic[0] = 'X';
+	assert(!player.load(badMagic.data(), badMagic.size()) && player.play(replayed) == ReplayPlayer::Result::BAD_FORMAT
+		&& "ReplayPlayer accepted a bad header");
+
+	// a record claiming ~2^61 idle loops is rejected, rather than run
+	std::vector<std::uint8_t> longGap{ file.begin(), file.begin() + sizeof(ReplayFormat::MAGIC) + 1 };
+	ReplayFormat::writeVarint(99, bytes);
+	longGap.push_back(bytes[0]);
+	longGap.push_back(static_cast<std::uint8_t>(RandomizerMode::HISTORY));
+	longGap.insert(longGap.end(), bytes, bytes + ReplayFormat::writeVarint(~0ull - 1, bytes));
+	assert(player.load(longGap.data(), longGap.size()) && player.play(replayed) == ReplayPlayer::Result::BAD_FORMAT
+		&& player.seek(replayed, 1000) == ReplayPlayer::Result::BAD_FORMAT && "ReplayPlayer ran an impossible loop gap");
+
+	// keyframes that would restore an impossible game are rejected, rather than restored
+	assert(ReplayFormat::findKeyframe(file.data(), file.size(), 300, keyframeLoop, keyframeOffset) && "ReplayFormat::findKeyframe()");
+	TetrisSimulation::State keyframe;
+	const std::uint8_t* payload = file.data() + keyframeOffset;
+	assert(ReplayFormat::readKeyframe(payload, file.data() + file.size(), keyframe) && "ReplayFormat::readKeyframe()");
+	const int payloadSize = static_cast<int>(payload - (file.data() + keyframeOffset));
+	for (int corruption = 0; corruption < 5; corruption++) {
+		TetrisSimulation::State corrupted{ keyframe };
+		switch (corruption) {
+		case 0: corrupted.currentShape = static_cast<TetShape>(9); break;
+		case 1: corrupted.randomizer.bag[0] = 9; break;
+		case 2: corrupted.currentX = 50; break;
+		case 3: corrupted.lockedRowsTop = 5; break;
+		default:
+			// recolor a filled block with a color that doesn't exist
+			for (int cell = 0; cell < Gameboard::MAX_Y * Gameboard::MAX_X; cell++) {
+				signed char& content = corrupted.cells[cell / Gameboard::MAX_X][cell % Gameboard::MAX_X];
+				if (content != Gameboard::EMPTY_BLOCK) {
+					content = 12;
+					break;
+				}
+			}
+			break;
+		}
+		assert(!TetrisSimulation::isStateValid(corrupted) && "TetrisSimulation::isStateValid() missed a corrupt state");
+		assert(!replayed.restoreState(corrupted) && "TetrisSimulation::restoreState() restored a corrupt state");
+		std::uint8_t encoded[ReplayFormat::MAX_KEYFRAME_SIZE];
+		assert(ReplayFormat::writeKeyframe(corrupted, encoded) == payloadSize && "corrupt keyframe changed size");
+		std::vector<std::uint8_t> damaged{ file };
+		std::copy(encoded, encoded + payloadSize, damaged.begin() + keyframeOffset);
+		assert(player.load(damaged.data(), damaged.size()) && player.seek(replayed, 300) == ReplayPlayer::Result::BAD_FORMAT
+			&& player.play(replayed) != ReplayPlayer::Result::OK && "ReplayPlayer restored a corrupt keyframe");
+	}
+	assert(TetrisSimulation::isStateValid(keyframe) && "TetrisSimulation::isStateValid() rejected a real keyframe");
+
+	// a replay whose END doesn't match its events (here: no events, but the first game's ending)
+	ReplayRecorder wrongRecorder;
+	assert(wrongRecorder.open(path, 99, RandomizerMode::HISTORY) && wrongRecorder.finish(game) && "ReplayRecorder mismatched replay");
+	const ReplayPlayer::Result wrong = (player.load(path), player.play(replayed));
+	assert((wrong == ReplayPlayer::Result::SCORE_MISMATCH || wrong == ReplayPlayer::Result::BOARD_MISMATCH)
+		&& "ReplayPlayer missed a mismatched ending");
+
+	// an empty game replays fine
+	TetrisSimulation emptyGame(99, RandomizerMode::HISTORY);
+	assert(wrongRecorder.open(path, 99, RandomizerMode::HISTORY) && wrongRecorder.finish(emptyGame) && "ReplayRecorder empty replay");
+	assert(player.load(path) && player.play(replayed) == ReplayPlayer::Result::OK && "ReplayPlayer empty replay");
+	std::remove(path.c_str());
+
+}
+
+
+
+void TestSuite::testHotPathAllocations()
+{
+
+	TetrisSimulation game;
+
+	// sanity check the hook itself
+	long long before = AllocationCounter::getAllocationCount();
+	void* probe = ::operator new(16);
+	::operator delete(probe);
+	assert(AllocationCounter::getAllocationCount() - before == 1 &&
+		"AllocationCounter did not count an allocation");
+
+	// move, rotate, drop and lock through the same calls the keyboard uses
+	before = AllocationCounter::getAllocationCount();
+	for (int i = 0; i < 100; i++) {
+		game.applyInput(GameInput::ROTATE);
+		game.applyInput(i % 2 == 0 ? GameInput::LEFT : GameInput::RIGHT);
+		game.applyInput(GameInput::SOFT_DROP);
+		game.tick();
+		game.applyInput(GameInput::HARD_DROP);
+		game.processGameLoop(0.0f);
+		game.board.fillRow(Gameboard::MAX_Y - 1, 1);
+		game.board.fillRow(Gameboard::MAX_Y - 3, 1);
+		game.applyInput(GameInput::HARD_DROP);
+		game.processGameLoop(0.0f);
+		game.reset();
+	}
+	assert(AllocationCounter::getAllocationCount() == before &&
+		"the move/rotate/drop/lock path should not allocate");
+
+}
@@ -0,0 +1,60 @@
+#ifndef TESTSUITE_H
+#define TESTSUITE_H
+
+// The automated tests for the game's classes, built as their own executable
+// (the Tests project) so the game itself starts straight into its window.
+//
+// Each test case covers one class and shares nothing with the others, so
+// runTestSuite() runs them in parallel. Cases that measure process wide
+// state (the allocation counter) run on their own once the rest are done.
+// A failed check asserts (asserts stay on in every Tests build).
+//-----------------------------------------------------------------------
+
+#include <string>
+
+class TestSuite {
+
+private:
+	static const int BLOCK_COUNT{ 4 };	// # of blocks in a Tetromino
+
+	struct TestCase
+	{
+		const char* name;
+		void (*run)();
+		bool exclusive;		// must run with no other case running (eg: it prints to std::cout)
+	};
+	static const TestCase TEST_CASES[];
+	static const int TEST_CASE_COUNT;
+
+	static void testPointClass();		// tests for the Point class
+	static void testTetrominoClass();	// tests for the Tetromino class
+	static void testGameboardClass();
+	static void testGridTetrominoClass(); // tests for the GridTetromino class
+	static void testTetrisSimulationClass(); // tests for the TetrisSimulation class
+	static void testPieceRandomizerClass(); // tests for the PieceRandomizer class
+	static void testPlacementGeneratorClass(); // tests for the PlacementGenerator class
+	static void testReachabilitySearchClass(); // tests for the ReachabilitySearch class
+	static void testTaskPoolClass(); // tests for the TaskPool class
+	static void testTickSchedulerClass(); // tests for the TickScheduler class & fixed step gravity
+	static void testInputStageClass(); // tests for the InputStage class
+	static void testAutoShiftClass(); // tests for the AutoShift class & shifting to the wall
+	static void testSpscQueueClass(); // tests for the SpscQueue class
+	static void testTripleBufferClass(); // tests for the TripleBuffer class & GameSnapshot
+	static void testWakeSignalClass(); // tests for the WakeSignal class
+	static void testFrameProfilerClass(); // tests for the FrameProfiler & TimingHistogram classes
+	static void testTetrisBotClass(); // tests for the TetrisBot class
+	static void testReplayClasses(); // tests for the ReplayRecorder & ReplayPlayer classes
+	static void testHotPathAllocations(); // the move/rotate/drop/lock path must not allocate
+
+public:
+	// run every test case whose name contains filter, and report each one
+	// - param 1: the number of threads to run cases on (1 runs them in order)
+	// - param 2: only run cases with this in their name ("" runs them all)
+	// - param 3: show what the cases print to the console, otherwise it's discarded
+	//            (only exclusive cases print, after the parallel ones)
+	// - return: the number of cases run
+	static int runTestSuite(unsigned int threadCount, const std::string& filter, bool verbose);
+};
+
+
+#endif // !TESTSUITE_H
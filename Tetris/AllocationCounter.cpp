@@ -0,0 +1,51 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<long long> allocationCount{ 0 };
+
+	void* countedAllocate(std::size_t size)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		void* memory = std::malloc(size == 0 ? 1 : size);
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+}
+
+long long AllocationCounter::getAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+// replacements for the global allocation functions
+void* operator new(std::size_t size)
+{
+	return countedAllocate(size);
+}
+void* operator new[](std::size_t size)
+{
+	return countedAllocate(size);
+}
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
@@ -0,0 +1,20 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+// Counts heap allocations made through the global operator new.
+// AllocationCounter.cpp replaces operator new/delete, so only link it into
+// builds that want the count (tests and benchmarks).
+// Usage:
+//   long long before = AllocationCounter::getAllocationCount();
+//   ... code under test ...
+//   long long allocations = AllocationCounter::getAllocationCount() - before;
+class AllocationCounter
+{
+public:
+	// get the number of allocations made since the program started (all threads)
+	// - params: none
+	// - return: the allocation count
+	static long long getAllocationCount();
+};
+
+#endif /* ALLOCATIONCOUNTER_H */
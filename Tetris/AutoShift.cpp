@@ -0,0 +1,146 @@
+#include "AutoShift.h"
+#include "Gameboard.h"
+
+const std::chrono::nanoseconds AutoShift::DEFAULT_DELAY{ std::chrono::milliseconds(150) };
+const std::chrono::nanoseconds AutoShift::DEFAULT_REPEAT{ std::chrono::milliseconds(33) };
+
+// constructor
+// - param 1: DAS, the hold before repeating
+// - param 2: ARR, the time between repeats (0 shifts to the wall)
+AutoShift::AutoShift(std::chrono::nanoseconds delay, std::chrono::nanoseconds repeat)
+	: delay{ delay }, repeat{ repeat }
+{
+}
+
+// change the timing, it takes effect from the next press
+// - param 1: DAS
+// - param 2: ARR
+// - return: nothing
+void AutoShift::setTiming(std::chrono::nanoseconds delay, std::chrono::nanoseconds repeat)
+{
+	this->delay = delay;
+	this->repeat = repeat;
+}
+
+// a direction key went down / up (events must be queued in time order)
+// - param 1: int direction, -1 for left, 1 for right
+// - param 2: when it happened
+// - return: false if the queue was full and the event was dropped
+bool AutoShift::press(int direction, Clock::time_point time)
+{
+	return push(direction, true, time);
+}
+
+bool AutoShift::release(int direction, Clock::time_point time)
+{
+	return push(direction, false, time);
+}
+
+bool AutoShift::push(int direction, bool pressed, Clock::time_point time)
+{
+	if (count == EVENT_CAPACITY)
+	{
+		return false;
+	}
+	events[(front + count) % EVENT_CAPACITY] = KeyEvent{ direction < 0 ? -1 : 1, pressed, time };
+	count++;
+	return true;
+}
+
+// apply a key event to the held/direction state
+//   a press takes over the direction, releasing the direction hands it to the other
+//   one if that's still held, either way the new direction starts charging (DAS)
+void AutoShift::handle(const KeyEvent& event)
+{
+	const int index = event.direction < 0 ? 0 : 1;
+	held[index] = event.pressed;
+	if (event.pressed)
+	{
+		direction = event.direction;
+	}
+	else if (event.direction == direction)
+	{
+		direction = held[1 - index] ? -event.direction : 0;
+	}
+	else
+	{
+		return;		// releasing the direction that wasn't in charge changes nothing
+	}
+	nextShift = event.time + delay;
+	charged = false;
+}
+
+// run the key events and repeats due at or before a time, in time order
+// - param 1: the simulation to move the current shape in
+// - param 2: the time to run up to
+// - return: the number of columns the shape was moved
+int AutoShift::applyUntil(TetrisSimulation& simulation, Clock::time_point until)
+{
+	const GameInput input[2] = { GameInput::LEFT, GameInput::RIGHT };
+	int moved = 0;
+	int repeats = 0;	// repeats this call, past the board's width they can't move the shape any further
+	while (true)
+	{
+		const bool eventDue = count > 0 && events[front].time <= until;
+		const bool shiftDue = direction != 0 && !(charged && repeat.count() == 0) && nextShift <= until;
+		if (shiftDue && (!eventDue || nextShift < events[front].time))
+		{
+			charged = true;
+			if (repeat.count() == 0)
+			{
+				moved += simulation.shiftToWall(direction);
+				continue;
+			}
+			if (repeats < Gameboard::MAX_X)
+			{
+				const Point before = simulation.getCurrentShape().getGridLoc();
+				simulation.applyInput(input[direction < 0 ? 0 : 1]);
+				moved += simulation.getCurrentShape().getGridLoc().getX() != before.getX() ? 1 : 0;
+				repeats++;
+				nextShift += repeat;
+			}
+			else
+			{
+				// catching up after a stall, skip the repeats that can't do anything
+				const Clock::time_point limit = eventDue ? events[front].time : until;
+				nextShift += ((limit - nextShift) / repeat + 1) * repeat;
+			}
+		}
+		else if (eventDue)
+		{
+			handle(events[front]);
+			front = (front + 1) % EVENT_CAPACITY;
+			count--;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	// with ARR 0 a charged direction holds the shape against the wall (eg: each new shape)
+	if (charged && repeat.count() == 0 && direction != 0)
+	{
+		moved += simulation.shiftToWall(direction);
+	}
+	return moved;
+}
+
+// let go of both directions and forget the queued events
+// - params: none
+// - return: nothing
+void AutoShift::clear()
+{
+	front = 0;
+	count = 0;
+	held[0] = false;
+	held[1] = false;
+	direction = 0;
+	charged = false;
+}
+
+// - return: the direction repeating (or waiting for DAS), -1 left, 1 right, 0 none
+int AutoShift::getDirection() const
+{
+	return direction;
+}
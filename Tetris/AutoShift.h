@@ -0,0 +1,89 @@
+// The AutoShift engine repeats a held left/right key at a fixed, configurable
+// rate instead of relying on the operating system's key repeat.
+//
+//   DAS (delayed auto shift): how long a direction is held before it repeats
+//   ARR (auto repeat rate): the time between repeats, 0 moves straight to the
+//       wall (TetrisSimulation::shiftToWall()) and keeps the shape there
+//
+// press() & release() queue the key's down/up times (the first shift of a
+// press is the key's own LEFT/RIGHT input, sent through the InputStage).
+// applyUntil() is then called before each simulation step with the time that
+// step ends, and runs the repeats that fall due by then at their own times,
+// so the movement speed doesn't depend on the frame or step rate.
+// When both directions are held the last one pressed wins, and releasing it
+// charges the other one from the release.
+
+#ifndef AUTOSHIFT_H
+#define AUTOSHIFT_H
+
+#include "TetrisSimulation.h"
+#include <chrono>
+
+class AutoShift
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+	static const std::chrono::nanoseconds DEFAULT_DELAY;	// DAS, init to 150 ms
+	static const std::chrono::nanoseconds DEFAULT_REPEAT;	// ARR, init to 33 ms
+	static const int EVENT_CAPACITY = 16;	// queued key downs & ups, more are dropped
+
+private:
+	struct KeyEvent
+	{
+		int direction;			// -1 left, 1 right
+		bool pressed;			// false for a release
+		Clock::time_point time;
+	};
+
+	std::chrono::nanoseconds delay;
+	std::chrono::nanoseconds repeat;
+
+	KeyEvent events[EVENT_CAPACITY];
+	int front{ 0 };				// index of the oldest queued event
+	int count{ 0 };				// events queued
+
+	bool held[2]{ false, false };	// [0] left, [1] right
+	int direction{ 0 };			// the direction repeating (or charging), 0 if none
+	Clock::time_point nextShift;	// when direction next shifts
+	bool charged{ false };		// DAS has passed (with ARR 0, the shape is kept at the wall)
+
+	// queue a key event
+	bool push(int direction, bool pressed, Clock::time_point time);
+	// apply a key event to the held/direction state
+	void handle(const KeyEvent& event);
+
+public:
+	// constructor
+	// - param 1: DAS, the hold before repeating
+	// - param 2: ARR, the time between repeats (0 shifts to the wall)
+	explicit AutoShift(std::chrono::nanoseconds delay = DEFAULT_DELAY, std::chrono::nanoseconds repeat = DEFAULT_REPEAT);
+
+	// change the timing, it takes effect from the next press
+	// - param 1: DAS
+	// - param 2: ARR
+	// - return: nothing
+	void setTiming(std::chrono::nanoseconds delay, std::chrono::nanoseconds repeat);
+
+	// a direction key went down / up (events must be queued in time order)
+	// - param 1: int direction, -1 for left, 1 for right
+	// - param 2: when it happened
+	// - return: false if the queue was full and the event was dropped
+	bool press(int direction, Clock::time_point time);
+	bool release(int direction, Clock::time_point time);
+
+	// run the key events and repeats due at or before a time, in time order
+	// - param 1: the simulation to move the current shape in
+	// - param 2: the time to run up to
+	// - return: the number of columns the shape was moved
+	int applyUntil(TetrisSimulation& simulation, Clock::time_point until);
+
+	// let go of both directions and forget the queued events
+	// - params: none
+	// - return: nothing
+	void clear();
+
+	// - return: the direction repeating (or waiting for DAS), -1 left, 1 right, 0 none
+	int getDirection() const;
+};
+
+#endif /* AUTOSHIFT_H */
@@ -0,0 +1,172 @@
+#include "FrameProfiler.h"
+#include <cassert>
+#include <iomanip>
+
+const std::chrono::nanoseconds FrameProfiler::WINDOW{ std::chrono::seconds(5) };
+
+// constructor, starts timing
+// - param 1: the FrameProfiler (may be nullptr, to turn the timer off)
+// - param 2: the section to time, from addSection()
+FrameProfiler::ScopedTimer::ScopedTimer(FrameProfiler* profiler, int section)
+	: profiler{ profiler }, section{ section }, start{ Clock::now() }
+{
+}
+
+// destructor, records the time since construction
+FrameProfiler::ScopedTimer::~ScopedTimer()
+{
+	if (profiler != nullptr)
+	{
+		const Clock::time_point end = Clock::now();
+		profiler->record(section, end - start, end);
+	}
+}
+
+// constructor, with no sections
+FrameProfiler::FrameProfiler()
+	: startTime{ Clock::now() }
+{
+}
+
+// add a section to time (before any timing starts)
+// - param 1: its name
+// - return: its index, for record() & ScopedTimer
+int FrameProfiler::addSection(const std::string& name)
+{
+	sections.push_back(std::unique_ptr<Section>(new Section()));
+	sections.back()->name = name;
+	sections.back()->windowStart = startTime;
+	return static_cast<int>(sections.size()) - 1;
+}
+
+// count a section's duration
+// - param 1: the section
+// - param 2: the duration
+// - param 3: when it ended (moves the rolling window along)
+// - return: nothing
+void FrameProfiler::record(int section, std::chrono::nanoseconds duration, Clock::time_point now)
+{
+	assert(section >= 0 && section < getSectionCount() && "FrameProfiler section out of range");
+	Section& timed = *sections[section];
+	std::lock_guard<std::mutex> lock(timed.mutex);
+	rollWindow(timed, now);
+	timed.recent.record(duration);
+	timed.total.record(duration);
+}
+
+// - return: the number of sections
+int FrameProfiler::getSectionCount() const
+{
+	return static_cast<int>(sections.size());
+}
+
+// - param 1: a section
+// - return: its name
+const std::string& FrameProfiler::getSectionName(int section) const
+{
+	assert(section >= 0 && section < getSectionCount() && "FrameProfiler section out of range");
+	return sections[section]->name;
+}
+
+// a section's statistics over the last WINDOW to 2 * WINDOW
+// - param 1: the section
+// - param 2: the current time (durations older than 2 * WINDOW are dropped)
+// - return: the Stats
+FrameProfiler::Stats FrameProfiler::getRecentStats(int section, Clock::time_point now)
+{
+	assert(section >= 0 && section < getSectionCount() && "FrameProfiler section out of range");
+	Section& timed = *sections[section];
+	TimingHistogram merged;
+	{
+		std::lock_guard<std::mutex> lock(timed.mutex);
+		rollWindow(timed, now);
+		merged.add(timed.previous);
+		merged.add(timed.recent);
+	}
+	return getStats(merged);
+}
+
+// a section's statistics over the whole run
+// - param 1: the section
+// - return: the Stats
+FrameProfiler::Stats FrameProfiler::getTotalStats(int section)
+{
+	assert(section >= 0 && section < getSectionCount() && "FrameProfiler section out of range");
+	Section& timed = *sections[section];
+	std::lock_guard<std::mutex> lock(timed.mutex);
+	return getStats(timed.total);
+}
+
+// write every section's whole run & recent statistics, in microseconds
+// - param 1: the stream
+// - param 2: the current time
+// - return: nothing
+void FrameProfiler::writeReport(std::ostream& out, Clock::time_point now)
+{
+	const auto toMicroseconds = [](std::chrono::nanoseconds time) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+	};
+	const auto writeStats = [&](const std::string& name, const Stats& stats) {
+		out << std::left << std::setw(12) << name << std::right
+			<< std::setw(10) << stats.count
+			<< std::setw(10) << toMicroseconds(stats.mean)
+			<< std::setw(10) << toMicroseconds(stats.p50)
+			<< std::setw(10) << toMicroseconds(stats.p99)
+			<< std::setw(10) << toMicroseconds(stats.max) << "\n";
+	};
+	const auto writeHeader = [&](const std::string& title) {
+		out << title << "\n" << std::left << std::setw(12) << "section" << std::right
+			<< std::setw(10) << "count" << std::setw(10) << "mean us" << std::setw(10) << "p50 us"
+			<< std::setw(10) << "p99 us" << std::setw(10) << "max us" << "\n";
+	};
+
+	writeHeader("Whole run (" + std::to_string(std::chrono::duration_cast<std::chrono::seconds>(now - startTime).count()) + " s)");
+	for (int i = 0; i < getSectionCount(); i++)
+	{
+		writeStats(getSectionName(i), getTotalStats(i));
+	}
+	out << "\n";
+	writeHeader("Last " + std::to_string(std::chrono::duration_cast<std::chrono::seconds>(WINDOW).count()) + " to "
+		+ std::to_string(std::chrono::duration_cast<std::chrono::seconds>(2 * WINDOW).count()) + " s");
+	for (int i = 0; i < getSectionCount(); i++)
+	{
+		writeStats(getSectionName(i), getRecentStats(i, now));
+	}
+}
+
+// start a new window half if this one has run for WINDOW
+//   (called with the section's mutex held)
+// - param 1: the section
+// - param 2: the current time
+// - return: nothing
+void FrameProfiler::rollWindow(Section& section, Clock::time_point now)
+{
+	if (now - section.windowStart < WINDOW)
+	{
+		return;
+	}
+	if (now - section.windowStart < 2 * WINDOW)
+	{
+		section.previous = section.recent;
+	}
+	else
+	{
+		section.previous.clear();	// nothing was recorded in the last WINDOW
+	}
+	section.recent.clear();
+	// keep the halves aligned to WINDOW boundaries
+	section.windowStart += ((now - section.windowStart) / WINDOW) * WINDOW;
+}
+
+// - param 1: a histogram
+// - return: its Stats
+FrameProfiler::Stats FrameProfiler::getStats(const TimingHistogram& histogram)
+{
+	Stats stats;
+	stats.count = histogram.getCount();
+	stats.mean = histogram.getMean();
+	stats.p50 = histogram.getPercentile(50.0);
+	stats.p99 = histogram.getPercentile(99.0);
+	stats.max = histogram.getMax();
+	return stats;
+}
@@ -0,0 +1,130 @@
+// The FrameProfiler times named sections of the game (event polling, the
+// simulation, drawing, display) into TimingHistograms, for the profiler
+// overlay and the report written when the game exits.
+//
+// Sections are added up front with addSection(). A ScopedTimer then times
+// one from its construction to the end of its scope:
+//     { FrameProfiler::ScopedTimer timer(&profiler, drawSection); game.draw(); }
+// Each section keeps a rolling histogram of the last WINDOW to 2 * WINDOW
+// (two halves, the older dropped as a new one starts) and one of the whole run.
+//
+// Sections can be timed from any thread (the simulation thread times its
+// steps while the window thread times the drawing), each has its own mutex,
+// only held to count a duration or read its statistics.
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include "TimingHistogram.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class FrameProfiler
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+	static const std::chrono::nanoseconds WINDOW;	// the rolling histograms' half length, init to 5 s
+
+	// a section's statistics, read from one of its histograms
+	struct Stats
+	{
+		unsigned long long count;
+		std::chrono::nanoseconds mean;
+		std::chrono::nanoseconds p50;
+		std::chrono::nanoseconds p99;
+		std::chrono::nanoseconds max;
+	};
+
+	// times a section from construction to destruction
+	class ScopedTimer
+	{
+	private:
+		FrameProfiler* profiler;	// nullptr times nothing
+		int section;
+		Clock::time_point start;
+
+	public:
+		// constructor, starts timing
+		// - param 1: the FrameProfiler (may be nullptr, to turn the timer off)
+		// - param 2: the section to time, from addSection()
+		ScopedTimer(FrameProfiler* profiler, int section);
+
+		// destructor, records the time since construction
+		~ScopedTimer();
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+	};
+
+private:
+	struct Section
+	{
+		std::string name;
+		std::mutex mutex;
+		TimingHistogram recent;		// since windowStart
+		TimingHistogram previous;	// the WINDOW before windowStart
+		TimingHistogram total;		// the whole run
+		Clock::time_point windowStart;
+	};
+
+	std::vector<std::unique_ptr<Section>> sections;
+	const Clock::time_point startTime;	// when the profiler was created
+
+public:
+	// constructor, with no sections
+	FrameProfiler();
+
+	// add a section to time (before any timing starts)
+	// - param 1: its name
+	// - return: its index, for record() & ScopedTimer
+	int addSection(const std::string& name);
+
+	// count a section's duration
+	// - param 1: the section
+	// - param 2: the duration
+	// - param 3: when it ended (moves the rolling window along)
+	// - return: nothing
+	void record(int section, std::chrono::nanoseconds duration, Clock::time_point now);
+
+	// - return: the number of sections
+	int getSectionCount() const;
+
+	// - param 1: a section
+	// - return: its name
+	const std::string& getSectionName(int section) const;
+
+	// a section's statistics over the last WINDOW to 2 * WINDOW
+	// - param 1: the section
+	// - param 2: the current time (durations older than 2 * WINDOW are dropped)
+	// - return: the Stats
+	Stats getRecentStats(int section, Clock::time_point now);
+
+	// a section's statistics over the whole run
+	// - param 1: the section
+	// - return: the Stats
+	Stats getTotalStats(int section);
+
+	// write every section's whole run & recent statistics, in microseconds
+	// - param 1: the stream
+	// - param 2: the current time
+	// - return: nothing
+	void writeReport(std::ostream& out, Clock::time_point now);
+
+private:
+	// start a new window half if this one has run for WINDOW
+	//   (called with the section's mutex held)
+	// - param 1: the section
+	// - param 2: the current time
+	// - return: nothing
+	static void rollWindow(Section& section, Clock::time_point now);
+
+	// - param 1: a histogram
+	// - return: its Stats
+	static Stats getStats(const TimingHistogram& histogram);
+};
+
+#endif /* FRAMEPROFILER_H */
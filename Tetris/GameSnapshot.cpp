@@ -0,0 +1,48 @@
+#include "GameSnapshot.h"
+#include "TetrisSimulation.h"
+
+// copy the game's drawable state out of a simulation
+// - param 1: the simulation
+// - param 2: the revision number to give this snapshot
+// - return: nothing
+void GameSnapshot::capture(const TetrisSimulation& simulation, unsigned long long revision)
+{
+	// the cells are only copied when this snapshot's board is out of date
+	// (a snapshot buffer can be reused several captures later)
+	const Gameboard& board = simulation.getBoard();
+	if (boardRevision != simulation.getBoardRevision())
+	{
+		for (int y = 0; y < Gameboard::MAX_Y; y++)
+		{
+			for (int x = 0; x < Gameboard::MAX_X; x++)
+			{
+				cells[y][x] = static_cast<signed char>(board.getContent(x, y));
+			}
+		}
+		boardRevision = simulation.getBoardRevision();
+	}
+	currentShape = simulation.getCurrentShape();
+	ghostShape = currentShape;
+	ghostShape.move(0, simulation.getDropDistance(ghostShape));
+	nextShape = simulation.getNextShape();
+	score = simulation.getScore();
+	this->revision = revision;
+}
+
+// whether capturing the simulation now would draw the same as this snapshot
+// - param 1: the simulation
+// - return: bool
+bool GameSnapshot::isCurrent(const TetrisSimulation& simulation) const
+{
+	const GridTetromino& current = simulation.getCurrentShape();
+	const GridTetromino& next = simulation.getNextShape();
+	return revision != 0 &&
+		boardRevision == simulation.getBoardRevision() &&
+		score == simulation.getScore() &&
+		currentShape.getShape() == current.getShape() &&
+		currentShape.getRotation() == current.getRotation() &&
+		currentShape.getGridLoc().getX() == current.getGridLoc().getX() &&
+		currentShape.getGridLoc().getY() == current.getGridLoc().getY() &&
+		nextShape.getShape() == next.getShape() &&
+		nextShape.getRotation() == next.getRotation();
+}
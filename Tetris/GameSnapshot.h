@@ -0,0 +1,40 @@
+// An immutable copy of everything needed to draw a game: the board, the
+// current shape & its ghost (landing spot), the next shape and the score.
+//
+// The simulation thread capture()s one after every change and publishes it
+// through a TripleBuffer, so the render thread draws from its own copy and
+// never touches the TetrisSimulation. It's plain data, so copying and
+// capturing don't allocate.
+
+#ifndef GAMESNAPSHOT_H
+#define GAMESNAPSHOT_H
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+
+class TetrisSimulation;
+
+struct GameSnapshot
+{
+	signed char cells[Gameboard::MAX_Y][Gameboard::MAX_X];	// the board content
+	unsigned int boardRevision{ 0 };	// the simulation's getBoardRevision() for cells
+	GridTetromino currentShape;
+	GridTetromino ghostShape;			// the currentShape moved down to where it would land
+	GridTetromino nextShape;
+	int score{ 0 };
+	unsigned long long revision{ 0 };	// counts captures, a new value means something changed
+
+	// copy the game's drawable state out of a simulation
+	// - param 1: the simulation
+	// - param 2: the revision number to give this snapshot
+	// - return: nothing
+	void capture(const TetrisSimulation& simulation, unsigned long long revision);
+
+	// whether capturing the simulation now would draw the same as this snapshot
+	//   (same board revision, shapes & score), so there's no need to publish one
+	// - param 1: the simulation
+	// - return: bool
+	bool isCurrent(const TetrisSimulation& simulation) const;
+};
+
+#endif /* GAMESNAPSHOT_H */
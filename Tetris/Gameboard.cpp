@@ -2,6 +2,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cassert>
+#include <algorithm>
 Gameboard::Gameboard()
 {
 	empty();
@@ -10,14 +11,54 @@ void Gameboard::empty()
 {
 	for (int col{ 0 }; col < MAX_Y; col++)
 	{
-		fillRow(col, EMPTY_BLOCK);
+		rowOrder[col] = static_cast<std::uint8_t>(col);
+		blankRow(col);
 	}
+	std::fill(columnHeights, columnHeights + MAX_X, 0);
 }
 void Gameboard::fillRow(int rowIndex, int content)
 {
+	if (content == EMPTY_BLOCK)
+	{
+		const bool hadContent = rowMasks[rowOrder[rowIndex]] != 0;
+		blankRow(rowIndex);
+		if (hadContent)
+		{
+			recomputeColumnHeights();
+		}
+		return;
+	}
+	const int row = rowOrder[rowIndex];
 	for (int x = 0; x < MAX_X; x++)
 	{
-		grid[rowIndex][x] = content;
+		grid[row][x] = static_cast<signed char>(content);
+		columnHeights[x] = std::max<std::uint8_t>(columnHeights[x], MAX_Y - rowIndex);
+	}
+	rowMasks[row] = FULL_ROW;
+	rowFill[row] = MAX_X;
+}
+void Gameboard::blankRow(int rowIndex)
+{
+	const int row = rowOrder[rowIndex];
+	std::fill(grid[row], grid[row] + MAX_X, static_cast<signed char>(EMPTY_BLOCK));
+	rowMasks[row] = 0;
+	rowFill[row] = 0;
+}
+void Gameboard::recomputeColumnHeights()
+{
+	std::fill(columnHeights, columnHeights + MAX_X, 0);
+	std::uint16_t found{ 0 };
+	for (int y{ 0 }; y < MAX_Y && found != FULL_ROW; y++)
+	{
+		std::uint16_t newColumns = rowMasks[rowOrder[y]] & ~found;
+		for (int x{ 0 }; newColumns != 0; x++, newColumns >>= 1)
+		{
+			if (newColumns & 1)
+			{
+				columnHeights[x] = MAX_Y - y;
+			}
+		}
+		found |= rowMasks[rowOrder[y]];
 	}
 }
 void Gameboard::printToConsole() const
@@ -26,12 +67,12 @@ void Gameboard::printToConsole() const
     {
         for (int x{ 0 }; x < MAX_X; ++x)
         {
-            if (grid[y][x] == EMPTY_BLOCK)
+            if (getContent(x, y) == EMPTY_BLOCK)
             {
                 std::cout << '.' << std::setw(2);
             }
             else {
-                std::cout << grid[y][x] << std::setw(2);
+                std::cout << getContent(x, y) << std::setw(2);
             }
         }
         std::cout << '\n';
@@ -40,12 +81,12 @@ void Gameboard::printToConsole() const
  int Gameboard::getContent(Point point) const
 {
     assert(isValidPoint(point));
-    return grid[point.getY()][point.getX()];
+    return grid[rowOrder[point.getY()]][point.getX()];
 }
  int Gameboard::getContent(int x, int y) const
 {
     assert(isValidPoint(x, y));
-    return grid[y][x];
+    return grid[rowOrder[y]][x];
 }
 bool Gameboard::isValidPoint(Point point) const
 {
@@ -57,20 +98,28 @@ bool Gameboard::isValidPoint(int x, int y) const
 }
 void Gameboard::copyRowIntoRow(int sourceRow, int targetRow)
 {
+    const int source = rowOrder[sourceRow];
+    const int target = rowOrder[targetRow];
     for (int x{ 0 }; x < MAX_X; x++)
     {
-        grid[targetRow][x] = grid[sourceRow][x];
+        grid[target][x] = grid[source][x];
     }
+    rowMasks[target] = rowMasks[source];
+    rowFill[target] = rowFill[source];
+    recomputeColumnHeights();
 }
 void Gameboard::removeRow(int rowIndex)
 {
     assert(rowIndex >= 0 && rowIndex < MAX_Y);
 
+    const std::uint8_t removedRow = rowOrder[rowIndex];
     for (int y{ rowIndex - 1 }; y >= 0; y--)
     {
-        copyRowIntoRow(y, y + 1);
+        rowOrder[y + 1] = rowOrder[y];
     }
-    fillRow(0, EMPTY_BLOCK);
+    rowOrder[0] = removedRow;
+    blankRow(0);
+    recomputeColumnHeights();
 }
 
 void Gameboard::removeRows(std::vector<int>& row)
@@ -84,31 +133,68 @@ void Gameboard::setContent(int x, int y, int content)
 {
     if (isValidPoint(x, y))
     {
-        grid[y][x] = content;
+        const int row = rowOrder[y];
+        const bool wasEmpty = (rowMasks[row] & (1 << x)) == 0;
+        grid[row][x] = static_cast<signed char>(content);
+        if (content == EMPTY_BLOCK)
+        {
+            if (!wasEmpty)
+            {
+                rowMasks[row] &= ~(1 << x);
+                rowFill[row]--;
+                if (columnHeights[x] == MAX_Y - y)
+                {
+                    // this was the top of the column, find the next block down
+                    int below{ y + 1 };
+                    while (below < MAX_Y && (rowMasks[rowOrder[below]] & (1 << x)) == 0)
+                    {
+                        below++;
+                    }
+                    columnHeights[x] = MAX_Y - below;
+                }
+            }
+        }
+        else if (wasEmpty) {
+            rowMasks[row] |= (1 << x);
+            rowFill[row]++;
+            columnHeights[x] = std::max<std::uint8_t>(columnHeights[x], MAX_Y - y);
+        }
     }
 }
 void Gameboard::setContent(Point p, int content)
 {
-    if (isValidPoint(p))
+    setContent(p.getX(), p.getY(), content);
+}
+void Gameboard::setContent(const std::vector<Point>& locations, int content)
+{
+    for (const Point& p : locations)
     {
-        grid[p.getY()][p.getX()] = content;
+        setContent(p.getX(), p.getY(), content);
     }
-    
 }
-void Gameboard::setContent(const std::vector<Point>& locations, int content)
+void Gameboard::setContent(const BlockLocs& locations, int content)
 {
     for (const Point& p : locations)
     {
-        grid[p.getY()][p.getX()] = content;
+        setContent(p.getX(), p.getY(), content);
     }
 }
 bool Gameboard::areAllLocsEmpty(const std::vector<Point>& locations) const
 {
-    for (const Point& point : locations)
+    return areAllLocsEmpty(locations.data(), locations.size());
+}
+bool Gameboard::areAllLocsEmpty(const BlockLocs& locations) const
+{
+    return areAllLocsEmpty(locations.data(), locations.size());
+}
+bool Gameboard::areAllLocsEmpty(const Point* locations, std::size_t count) const
+{
+    for (std::size_t i{ 0 }; i < count; i++)
     {
+        const Point& point = locations[i];
         if (isValidPoint(point))
         {
-            if (grid[point.getY()][point.getX()] != EMPTY_BLOCK)
+            if (rowMasks[rowOrder[point.getY()]] & (1 << point.getX()))
             {
                 return false;
             }
@@ -116,17 +202,25 @@ bool Gameboard::areAllLocsEmpty(const std::vector<Point>& locations) const
     }
     return true;
 }
+std::uint16_t Gameboard::getRowMask(int y) const
+{
+    assert(y >= 0 && y < MAX_Y);
+    return rowMasks[rowOrder[y]];
+}
+int Gameboard::getRowFillCount(int y) const
+{
+    assert(y >= 0 && y < MAX_Y);
+    return rowFill[rowOrder[y]];
+}
+int Gameboard::getColumnHeight(int x) const
+{
+    assert(x >= 0 && x < MAX_X);
+    return columnHeights[x];
+}
 bool Gameboard::isRowCompleted(int row) const
 {
     assert(row >= 0 && row < MAX_Y);
-    for (int x{ 0 }; x < MAX_X; x++)
-    {
-        if (grid[row][x] == EMPTY_BLOCK)
-        {
-            return false;
-        }
-    }
-    return true;
+    return rowMasks[rowOrder[row]] == FULL_ROW;
 }
 std::vector<int> Gameboard::getCompletedRowIndices() const
 {
@@ -142,17 +236,91 @@ std::vector<int> Gameboard::getCompletedRowIndices() const
     return completedRows;
 }
 //	// Remove all completed rows from the board
-//	//   use getCompletedRowIndices() and removeRows() 
+//	//   see removeCompletedRows(CompletedRows&)
 //	// - params: none
 //	// - return: the count of completed rows removed
 int Gameboard::removeCompletedRows()
 {
-    std::vector<int> completedRows = getCompletedRowIndices();
-    removeRows(completedRows);
-    return completedRows.size();
+    CompletedRows completedRows;
+    return removeCompletedRows(completedRows);
+}
+//	// Remove all completed rows from the board in a single bottom-up pass.
+//	// - param 1: a CompletedRows to fill in with the removed row indices
+//	// - return: the count of completed rows removed
+int Gameboard::removeCompletedRows(CompletedRows& completedRows)
+{
+    return removeCompletedRows(0, MAX_Y - 1, completedRows);
 }
+//	// Remove the completed rows in [firstRow, lastRow].
+//	//   Surviving rows keep their storage, only their rowOrder entries move.
+//	//   The removed rows' storage is blanked and reused as the new top rows.
+//	// - param 1: an int, the first (top) row to test, clamped to the board
+//	// - param 2: an int, the last (bottom) row to test, clamped to the board
+//	// - param 3: a CompletedRows to fill in with the removed row indices
+//	// - return: the count of completed rows removed
+int Gameboard::removeCompletedRows(int firstRow, int lastRow, CompletedRows& completedRows)
+{
+    firstRow = std::max(firstRow, 0);
+    lastRow = std::min(lastRow, MAX_Y - 1);
+    completedRows.count = 0;
+    for (int y{ firstRow }; y <= lastRow; y++)
+    {
+        if (rowFill[rowOrder[y]] == MAX_X)
+        {
+            completedRows.indices[completedRows.count++] = y;
+        }
+    }
+    if (completedRows.count == 0)
+    {
+        return 0;
+    }
 
-Point Gameboard::getSpawnLoc()
+    // slide the surviving rows at and above lastRow down, bottom-up
+    std::uint8_t newOrder[MAX_Y];
+    int targetRow{ lastRow };       // where the next surviving row belongs
+    int nextCompleted{ completedRows.count - 1 };
+    for (int y{ lastRow }; y >= 0; y--)
+    {
+        if (nextCompleted >= 0 && completedRows.indices[nextCompleted] == y)
+        {
+            nextCompleted--;
+        }
+        else {
+            newOrder[targetRow--] = rowOrder[y];
+        }
+    }
+    // the removed rows become the (empty) rows at the top
+    for (int i{ 0 }; i < completedRows.count; i++)
+    {
+        newOrder[i] = rowOrder[completedRows.indices[i]];
+    }
+    std::copy(newOrder, newOrder + lastRow + 1, rowOrder);
+    for (int y{ 0 }; y < completedRows.count; y++)
+    {
+        blankRow(y);
+    }
+    recomputeColumnHeights();
+    return completedRows.count;
+}
+
+Point Gameboard::getSpawnLoc() const
 {
     return spawnLoc;
 }
+
+// a hash of the board's content (FNV-1a over every block, top row first)
+// - params: none
+// - return: the 64 bit hash
+std::uint64_t Gameboard::getContentHash() const
+{
+    std::uint64_t hash{ 0xCBF29CE484222325ull };
+    for (int y{ 0 }; y < MAX_Y; y++)
+    {
+        for (int x{ 0 }; x < MAX_X; x++)
+        {
+            hash ^= static_cast<std::uint8_t>(getContent(x, y));
+            hash *= 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
@@ -2,7 +2,9 @@
 #define GAMEBOARD_H
 
 #include <vector>
+#include <cstdint>
 #include "Point.h"
+#include "Tetromino.h"
 
 class Gameboard
 {
@@ -10,6 +12,14 @@ public:
 	static const int MAX_X = 10;		// gameboard x dimension
 	static const int MAX_Y = 19;		// gameboard y dimension
 	static const int EMPTY_BLOCK = -1;	// contents of an empty block
+	static const std::uint16_t FULL_ROW = (1 << MAX_X) - 1;	// occupancy mask of a completed row
+
+	// the rows removed by one removeCompletedRows() call
+	struct CompletedRows
+	{
+		int count{ 0 };			// how many rows were removed
+		int indices[MAX_Y];		// the removed row indices (before removal), top to bottom
+	};
 	// METHODS -------------------------------------------------
 // 
 // constructor - empty() the grid
@@ -58,6 +68,11 @@ public:
 	// - param 2: an int representing the content we want to set.
 	void setContent(const std::vector<Point>& locations, int content);
 
+	// set the content for the blocks of a tetromino (ignore invalid points)
+	// - param 1: the BlockLocs of a tetromino
+	// - param 2: an int representing the content we want to set.
+	void setContent(const BlockLocs& locations, int content);
+
 	// Determine if (valid) all points passed in are empty
 	// *** IMPORTANT: Assume invalid x,y values can be passed to this method.
 	// Invalid meaning outside the bounds of the grid.
@@ -67,26 +82,91 @@ public:
 	// - return: true if the content at ALL VALID points is EMPTY_BLOCK, false otherwise
 	bool areAllLocsEmpty(const std::vector<Point>& locations) const;
 
+	// Determine if (valid) all block locations of a tetromino are empty
+	// (same rules as above)
+	// - param 1: the BlockLocs of a tetromino
+	// - return: true if the content at ALL VALID points is EMPTY_BLOCK, false otherwise
+	bool areAllLocsEmpty(const BlockLocs& locations) const;
+
+	// get the occupancy mask for a row (bit x is set when column x is not EMPTY_BLOCK)
+	// assert the row index is valid
+	// - param 1: an int representing the row index
+	// - return: a 16 bit mask, FULL_ROW when the row is completed
+	std::uint16_t getRowMask(int y) const;
+
+	// get the number of non-empty blocks in a row (kept up to date by every write)
+	// assert the row index is valid
+	// - param 1: an int representing the row index
+	// - return: an int in [0, MAX_X], MAX_X when the row is completed
+	int getRowFillCount(int y) const;
+
+	// get the height of a column's stack (kept up to date by every write)
+	// assert the column index is valid
+	// - param 1: an int representing the column index
+	// - return: MAX_Y - (the row of the column's highest block), 0 for an empty column
+	int getColumnHeight(int x) const;
+
 	// Remove all completed rows from the board
-	//   use getCompletedRowIndices() and removeRows() 
+	//   see removeCompletedRows(CompletedRows&)
 	// - params: none
 	// - return: the count of completed rows removed
 	int removeCompletedRows();
 
+	// Remove all completed rows from the board in a single bottom-up pass.
+	//   Each surviving row is copied at most once, straight to its final row,
+	//   and the rows left over at the top are filled with EMPTY_BLOCK.
+	// - param 1: a CompletedRows to fill in with the removed row indices
+	//            (for animation and scoring)
+	// - return: the count of completed rows removed
+	int removeCompletedRows(CompletedRows& completedRows);
+
+	// Same as above, but only rows in [firstRow, lastRow] are tested for completion
+	// (eg: the rows touched by the tetromino that was just locked).
+	// Rows below lastRow are never visited.
+	// - param 1: an int, the first (top) row to test, clamped to the board
+	// - param 2: an int, the last (bottom) row to test, clamped to the board
+	// - param 3: a CompletedRows to fill in with the removed row indices
+	// - return: the count of completed rows removed
+	int removeCompletedRows(int firstRow, int lastRow, CompletedRows& completedRows);
+
 	// A getter for the spawn location
 	// - params: none
 	// - returns: a Point, representing our private spawnLoc
-	Point getSpawnLoc();
+	Point getSpawnLoc() const;
+
+	// a hash of the board's content (FNV-1a over every block, top row first)
+	//   used to check that a replayed game ended on the same board
+	// - params: none
+	// - return: the 64 bit hash
+	std::uint64_t getContentHash() const;
 
 private:
 	/* MEMBER VARIABLES -------------------------------------------------
 
-	 the gameboard - a grid of X and Y offsets.  
+	 the gameboard offset to spawn a new tetromino at.
+
+	 the gameboard is stored as two planes:
+	  - rowMasks: one occupancy mask per row, bit x set when column x is filled.
+	    All collision and completed-row tests work on these.
+	  - grid: the content (color) of each block, only read when drawing.
 	  ([0][0] is top left, [MAX_Y-1][MAX_X-1] is bottom right) 
 
-	 the gameboard offset to spawn a new tetromino at.*/
+	 Rows are addressed through rowOrder: row y of the board is stored in
+	 rowMasks[rowOrder[y]] and grid[rowOrder[y]]. Removing a row only remaps
+	 entries in rowOrder and blanks the removed row's storage, row contents
+	 are never moved.
+
+	 rowFill (per stored row, like rowMasks) and columnHeights are updated
+	 as blocks are written, so they can be read without scanning the grid.*/
 	const Point spawnLoc{ MAX_X / 2, 0 };
-	int grid[MAX_Y][MAX_X];
+	std::uint8_t rowOrder[MAX_Y];
+	std::uint16_t rowMasks[MAX_Y];
+	std::uint8_t rowFill[MAX_Y];
+	std::uint8_t columnHeights[MAX_X];
+	signed char grid[MAX_Y][MAX_X];
+
+	static_assert(MAX_X <= 16, "a gameboard row must fit in a 16 bit mask");
+	static_assert(MAX_Y <= 256, "rowOrder entries must fit in a byte");
 	// Determine if a given Point is a valid grid location
 	// - param 1: a Point object
 	// - return: true if the point is a valid grid location, false otherwise
@@ -98,6 +178,12 @@ private:
 	// - return: true if the x,y is a valid grid location, false otherwise
 	bool isValidPoint(int x, int y) const;
 
+	// shared implementation of the areAllLocsEmpty() overloads
+	// - param 1: pointer to the first Point
+	// - param 2: the number of Points
+	// - return: true if the content at ALL VALID points is EMPTY_BLOCK, false otherwise
+	bool areAllLocsEmpty(const Point* locations, std::size_t count) const;
+
 	// return a bool indicating if a given row is full (no EMPTY_BLOCK in the row)
 	// assert the row index is valid
 	// - param 1: an int representing the row index we want to test
@@ -110,6 +196,18 @@ private:
 	// - return: nothing
 	void fillRow(int rowIndex, int content);
 
+	// fill a given grid row with EMPTY_BLOCK without updating columnHeights
+	// (for callers that recompute the heights once afterwards)
+	// - param 1: an int representing a row index
+	// - return: nothing
+	void blankRow(int rowIndex);
+
+	// rebuild columnHeights from the row masks, scanning down from the top
+	// until every column has been found (or the bottom is reached)
+	// - params: none
+	// - return: nothing
+	void recomputeColumnHeights();
+
 	// scan the board for completed rows.
 	// Iterate through grid rows and use isRowCompleted(rowIndex)
 	// - params: none
@@ -123,15 +221,12 @@ private:
 	void copyRowIntoRow(int sourceRow, int targetRow);
 
 	// In gameplay, when a full row is completed (filled with content)
-	// it gets "removed".  To be exact, the row itself is not removed
-	// but the content from the row above it is copied into it.
-	// This continues all the way up the grid until the first row is copied
-	// into the second row.  Finally, the first row is filled with EMPTY_BLOCK
+	// it gets "removed": every row above it moves one row downwards
+	// and the first row becomes empty.
 	// Given a row index:
 	//   1) Assert the row index is valid
-	//   2) Starting at rowIndex, copy each row above the removed
-	//     row "one-row-downwards" in the grid.
-	//     (loop from y=rowIndex-1 down to 0, and copyRowIntoRow(y, y+1)).
+	//   2) shift the rowOrder entries above rowIndex down by one,
+	//      moving the removed row's storage to the first row.
 	//   3) call fillRow() on the first row (and place EMPTY_BLOCKs in it).
 	// - param 1: an int representing a row index
 	// - return: nothing
@@ -28,18 +28,18 @@ void GridTetromino::move(int xOffset, int yOffset) {
 	gridLoc.setX(gridLoc.getX() + xOffset);
 	gridLoc.setY(gridLoc.getY() + yOffset);
 }
-// Build and return a vector of Points to represent our inherited
-// blockLocs vector mapped to the gridLoc of this object instance.
-// You will need to provide this class access to blockLocs (from the Tetromino class).
-// eg: if we have a Point [x,y] in our vector,
+// Build and return the Points of our inherited
+// block layout mapped to the gridLoc of this object instance.
+// eg: if we have a block offset [x,y] in our layout,
 // and our gridLoc is [5,6] the mapped Point would be [5+x,6+y].
 // params: none:
-// return: a vector of Point objects.
-std::vector<Point> GridTetromino::getBlockLocsMappedToGrid() const
+// return: BlockLocs (one Point per block).
+BlockLocs GridTetromino::getBlockLocsMappedToGrid() const
 {
-	std::vector<Point> blockLocsMappedToGrid{};
-	for (Point point : blockLocs) {
-		blockLocsMappedToGrid.push_back(Point{ point.getX() + gridLoc.getX(), point.getY() + gridLoc.getY() });
+	const TetrominoLayout& layout = getLayout();
+	BlockLocs blockLocsMappedToGrid;
+	for (int i = 0; i < BLOCK_COUNT; i++) {
+		blockLocsMappedToGrid[i].setXY(layout.blocks[i].x + gridLoc.getX(), layout.blocks[i].y + gridLoc.getY());
 	}
 	return blockLocsMappedToGrid;
 }
\ No newline at end of file
@@ -52,14 +52,14 @@ public:
 	// - return: nothing
 	void move(int xOffset, int yOffset);
 
-	// Build and return a vector of Points to represent our inherited
-	// blockLocs vector mapped to the gridLoc of this object instance.
-	// You will need to provide this class access to blockLocs (from the Tetromino class).
-	// eg: if we have a Point [x,y] in our vector,
+	// Build and return the Points of our inherited
+	// block layout mapped to the gridLoc of this object instance.
+	// eg: if we have a block offset [x,y] in our layout,
 	// and our gridLoc is [5,6] the mapped Point would be [5+x,6+y].
+	// The result is a fixed size array, so this never allocates.
 	// params: none:
-	// return: a vector of Point objects.
-	 std::vector<Point> getBlockLocsMappedToGrid() const;
+	// return: BlockLocs (one Point per block).
+	 BlockLocs getBlockLocsMappedToGrid() const;
 	 
 };
 
@@ -0,0 +1,105 @@
+#include "InputStage.h"
+
+// queue an input (inputs must be pushed in arrival order)
+// - param 1: the GameInput
+// - param 2: when it arrived (when its event was polled)
+// - return: false if the queue was full and the input was dropped
+bool InputStage::push(GameInput input, Clock::time_point arrival)
+{
+	if (count == CAPACITY)
+	{
+		droppedCount++;
+		return false;
+	}
+	queue[(front + count) % CAPACITY] = TimedInput{ input, arrival };
+	count++;
+	return true;
+}
+
+// apply every queued input that arrived at or before a time, oldest first
+// - param 1: the simulation to apply them to
+// - param 2: apply inputs that arrived at or before this time
+// - param 3: the time the inputs are reaching the board (for the latency)
+// - return: the number of inputs applied
+int InputStage::applyUntil(TetrisSimulation& simulation, Clock::time_point until, Clock::time_point appliedAt)
+{
+	int applied = 0;
+	while (count > 0 && queue[front].arrival <= until)
+	{
+		const TimedInput& timed = queue[front];
+		simulation.applyInput(timed.input);
+
+		const std::chrono::nanoseconds latency = appliedAt - timed.arrival;
+		latencyLast = latency;
+		latencyTotal += latency;
+		if (latency > latencyMax)
+		{
+			latencyMax = latency;
+		}
+		latencyCount++;
+
+		front = (front + 1) % CAPACITY;
+		count--;
+		applied++;
+	}
+	return applied;
+}
+
+// throw away the queued inputs
+// - params: none
+// - return: nothing
+void InputStage::clear()
+{
+	front = 0;
+	count = 0;
+}
+
+// - return: the number of inputs queued
+int InputStage::getQueuedCount() const
+{
+	return count;
+}
+
+// - return: the number of inputs dropped because the queue was full
+unsigned long long InputStage::getDroppedCount() const
+{
+	return droppedCount;
+}
+
+// key-to-board latency of the applied inputs
+// - params: none
+// - return: the statistic
+unsigned long long InputStage::getLatencyCount() const
+{
+	return latencyCount;
+}
+
+std::chrono::nanoseconds InputStage::getMeanLatency() const
+{
+	if (latencyCount == 0)
+	{
+		return std::chrono::nanoseconds::zero();
+	}
+	return latencyTotal / static_cast<std::chrono::nanoseconds::rep>(latencyCount);
+}
+
+std::chrono::nanoseconds InputStage::getMaxLatency() const
+{
+	return latencyMax;
+}
+
+std::chrono::nanoseconds InputStage::getLastLatency() const
+{
+	return latencyLast;
+}
+
+// start the latency statistics over
+// - params: none
+// - return: nothing
+void InputStage::resetLatencyStats()
+{
+	latencyCount = 0;
+	latencyTotal = std::chrono::nanoseconds::zero();
+	latencyMax = std::chrono::nanoseconds::zero();
+	latencyLast = std::chrono::nanoseconds::zero();
+}
@@ -0,0 +1,87 @@
+// The InputStage queues player inputs with the time they arrived, so the
+// simulation can apply each one at its true time rather than whenever the
+// next frame happens to come around.
+//
+// The window loop stamps every key event as it's polled and push()es it.
+// When the simulation catches up on its owed steps (see TickScheduler),
+// applyUntil() is called before each step with the time that step starts,
+// so inputs land between the same steps they happened between, and once
+// more with the current time for anything newer.
+//
+// Each applied input's latency (from its arrival to when it reached the
+// board) is measured, for the key-to-board statistics.
+// The queue is a fixed ring buffer, so pushing doesn't allocate.
+
+#ifndef INPUTSTAGE_H
+#define INPUTSTAGE_H
+
+#include "TetrisSimulation.h"
+#include <chrono>
+
+class InputStage
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+	static const int CAPACITY = 64;		// queued inputs, more are dropped
+
+private:
+	struct TimedInput
+	{
+		GameInput input;
+		Clock::time_point arrival;
+	};
+
+	TimedInput queue[CAPACITY];
+	int front{ 0 };						// index of the oldest queued input
+	int count{ 0 };						// inputs queued
+	unsigned long long droppedCount{ 0 };	// inputs that found the queue full
+
+	// key-to-board latency
+	unsigned long long latencyCount{ 0 };
+	std::chrono::nanoseconds latencyTotal{ 0 };
+	std::chrono::nanoseconds latencyMax{ 0 };
+	std::chrono::nanoseconds latencyLast{ 0 };
+
+public:
+	// queue an input (inputs must be pushed in arrival order)
+	// - param 1: the GameInput
+	// - param 2: when it arrived (when its event was polled)
+	// - return: false if the queue was full and the input was dropped
+	bool push(GameInput input, Clock::time_point arrival);
+
+	// apply every queued input that arrived at or before a time, oldest first
+	// - param 1: the simulation to apply them to
+	// - param 2: apply inputs that arrived at or before this time
+	// - param 3: the time the inputs are reaching the board (for the latency)
+	// - return: the number of inputs applied
+	int applyUntil(TetrisSimulation& simulation, Clock::time_point until, Clock::time_point appliedAt);
+
+	// throw away the queued inputs
+	// - params: none
+	// - return: nothing
+	void clear();
+
+	// - return: the number of inputs queued
+	int getQueuedCount() const;
+
+	// - return: the number of inputs dropped because the queue was full
+	unsigned long long getDroppedCount() const;
+
+	// key-to-board latency of the applied inputs
+	//   getLatencyCount(): inputs measured
+	//   getMeanLatency(), getMaxLatency(): over the measured inputs (0 if none)
+	//   getLastLatency(): the most recent input's
+	// - params: none
+	// - return: the statistic
+	unsigned long long getLatencyCount() const;
+	std::chrono::nanoseconds getMeanLatency() const;
+	std::chrono::nanoseconds getMaxLatency() const;
+	std::chrono::nanoseconds getLastLatency() const;
+
+	// start the latency statistics over
+	// - params: none
+	// - return: nothing
+	void resetLatencyStats();
+};
+
+#endif /* INPUTSTAGE_H */
@@ -1,16 +1,18 @@
 
 #include <SFML/Graphics.hpp>
+#include <algorithm>
 #include <iostream>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include "FrameProfiler.h"
+#include "ProfilerOverlay.h"
 #include "TetrisGame.h"
-#include "TestSuite.h"
 
 
 int main()
 {
 	try {
-		// run some sanity tests on our classes to ensure they're working as expected.
-		TestSuite::runTestSuite();
-		srand((unsigned int)time(NULL));
 		sf::Sprite blockSprite;			// the tetromino block sprite
 		sf::Texture blockTexture;		// the tetromino block texture
 		sf::Sprite backgroundSprite;	// the background sprite
@@ -28,48 +30,151 @@ int main()
 		// create the game window
 		sf::RenderWindow window(sf::VideoMode(640, 800), "Tetris Game Window");
 
-		window.setFramerateLimit(30);				// set a max framerate of 30 FPS
+		// The window is only redrawn when the game publishes a new snapshot (or the
+		// window itself needs it), at most at 60 FPS. In between, the loop sleeps
+		// until an event, a new snapshot, or the next frame if a redraw is waiting
+		// (see TetrisGame::waitForUpdate()).
+		// The simulation runs on its own thread (see TetrisGame::start()).
+		const std::chrono::nanoseconds frameLength{ 1000000000 / 60 };	// 60 FPS
 
 		const Point gameboardOffset{ 54, 125 };		// the pixel offset of the top left of the gameboard 
 		const Point nextShapeOffset{ 490, 210 };	// the pixel offset of the next shape Tetromino
 
-		// set up a tetris game
-		TetrisGame game(window, blockSprite, gameboardOffset, nextShapeOffset);
+		// time the stages of each frame (and each simulation loop), shown by F3,
+		// and written to frame_profile.txt on exit
+		//   (declared before the game, so if anything throws, the game's destructor
+		//   stops its simulation thread before the profiler it times into goes)
+		FrameProfiler profiler;
+		const int eventsSection = profiler.addSection("events");
+		const int simulationSection = profiler.addSection("simulation");
+		const int drawSection = profiler.addSection("draw");
+		const int displaySection = profiler.addSection("display");
+		ProfilerOverlay profilerOverlay(profiler, sf::Vector2f(8, 8));
+		if (!profilerOverlay.loadFont("fonts/RedOctober.ttf"))
+		{
+			std::cout << "Unable to load the profiler overlay font\n";
+		}
 
-		// set up a clock so we can determine seconds per game loop
-		sf::Clock clock;
+		// set up a tetris game, with a new shape sequence every launch
+		const std::uint64_t seed = static_cast<std::uint64_t>(std::time(nullptr));
+		TetrisGame game(window, blockSprite, gameboardOffset, nextShapeOffset, seed);
+		// keep a replay of the game (can be verified headless with ReplayPlayer)
+		if (!game.startRecording("last_game.replay"))
+		{
+			std::cout << "Unable to record last_game.replay\n";
+		}
+		game.setProfiler(&profiler, simulationSection);
+		game.start();
 
-		// create an event for handling userInput from the GUI (graphical user interface)
-		sf::Event guiEvent;
+		// the earliest time the window can be redrawn, and whether it needs to be
+		InputStage::Clock::time_point nextFrameTime = InputStage::Clock::now();
+		bool redraw = true;
 
 		// the main game loop
 		while (window.isOpen())
 		{
-			// how long since the last loop (fraction of a second)		
-			float elapsedTime = clock.getElapsedTime().asSeconds();
-			clock.restart();
-
 			// handle any window or keyboard events that have occured since the last game loop
-			sf::Event event;
-			while (window.pollEvent(event))
 			{
-				if (event.type == sf::Event::Closed)	// handle close button clicked
+				FrameProfiler::ScopedTimer timer(&profiler, eventsSection);
+				sf::Event event;
+				while (window.pollEvent(event))
 				{
-					window.close();
+					if (event.type == sf::Event::Closed)	// handle close button clicked
+					{
+						window.close();
+					}
+					else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3)
+					{
+						profilerOverlay.toggle();	// show/hide the profiler overlay
+						redraw = true;
+					}
+					else if (event.type == sf::Event::KeyPressed)
+					{
+						game.onKeyPressed(event, InputStage::Clock::now());	// handle key press
+					}
+					else if (event.type == sf::Event::KeyReleased)
+					{
+						game.onKeyReleased(event, InputStage::Clock::now());	// ends a held left/right
+					}
+					else if (event.type == sf::Event::LostFocus)
+					{
+						game.onFocusLost(InputStage::Clock::now());
+					}
+					else if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus)
+					{
+						redraw = true;	// the window contents may have been lost
+					}
 				}
-				else if (event.type == sf::Event::KeyPressed)
+				if (game.updateSnapshot())
 				{
-					game.onKeyPressed(event);	// handle key press
+					redraw = true;
 				}
 			}
 
-			game.processGameLoop(elapsedTime);	// handle tetris game logic in here.
+			const InputStage::Clock::time_point now = InputStage::Clock::now();
+			if (profilerOverlay.update(now))
+			{
+				redraw = true;
+			}
+			if (!redraw || now < nextFrameTime)
+			{
+				// wait for the next event or snapshot, the next frame (if a redraw is waiting),
+				// or the overlay's next refresh (if it's shown)
+				InputStage::Clock::time_point wakeTime = profilerOverlay.getNextRefreshTime();
+				if (redraw)
+				{
+					wakeTime = std::min(wakeTime, nextFrameTime);
+				}
+				game.waitForUpdate(wakeTime - now);
+				continue;
+			}
+			nextFrameTime = now + frameLength;
+			redraw = false;
 
 			// Draw the game to the screen
 			window.clear(sf::Color::White);	// clear the entire window
 			window.draw(backgroundSprite);	// draw the background (onto the window) 				
-			game.draw();
-			window.display();				// re-display the entire window
+			{
+				FrameProfiler::ScopedTimer timer(&profiler, drawSection);
+				game.draw();
+			}
+			profilerOverlay.draw(window);
+			{
+				FrameProfiler::ScopedTimer timer(&profiler, displaySection);
+				window.display();			// re-display the entire window
+			}
+		}
+
+		game.stop();
+
+		std::ofstream profileFile("frame_profile.txt");
+		if (profileFile)
+		{
+			profiler.writeReport(profileFile, FrameProfiler::Clock::now());
+		}
+		else
+		{
+			std::cout << "Unable to write frame_profile.txt\n";
+		}
+
+		// report any time the simulation couldn't catch up on (long stalls)
+		const TickScheduler& scheduler = game.getScheduler();
+		if (scheduler.getDropCount() > 0)
+		{
+			std::cout << "Simulation fell behind " << scheduler.getDropCount() << " times, dropping "
+				<< std::chrono::duration_cast<std::chrono::milliseconds>(scheduler.getDroppedTime()).count() << " ms\n";
+		}
+		const InputStage& inputStage = game.getInputStage();
+		const unsigned long long droppedInputs = game.getDroppedKeyInputCount() + inputStage.getDroppedCount();
+		if (droppedInputs > 0)
+		{
+			std::cout << "Dropped " << droppedInputs << " key inputs (input queues full)\n";
+		}
+		if (inputStage.getLatencyCount() > 0)
+		{
+			std::cout << "Key to board latency over " << inputStage.getLatencyCount() << " inputs: mean "
+				<< std::chrono::duration_cast<std::chrono::microseconds>(inputStage.getMeanLatency()).count() << " us, max "
+				<< std::chrono::duration_cast<std::chrono::microseconds>(inputStage.getMaxLatency()).count() << " us\n";
 		}
 	}
 	catch (std::runtime_error& ex) {
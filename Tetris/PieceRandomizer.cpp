@@ -0,0 +1,238 @@
+#include "PieceRandomizer.h"
+#include <istream>
+#include <ostream>
+
+// constructor
+// - param 1: the seed, the same seed and mode always produce the same shapes
+// - param 2: the RandomizerMode
+PieceRandomizer::PieceRandomizer(std::uint64_t seed, RandomizerMode mode)
+{
+	reseed(seed, mode);
+}
+
+// restart the sequence from a seed
+// - param 1: the seed
+// - param 2: the RandomizerMode
+// - return: nothing
+void PieceRandomizer::reseed(std::uint64_t seed, RandomizerMode mode)
+{
+	state.mode = mode;
+
+	// run the seed through splitmix64 so similar seeds give unrelated sequences
+	std::uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	z = z ^ (z >> 31);
+	state.rng = (z == 0) ? 0x9E3779B97F4A7C15ull : z;
+
+	refillBag();
+	// start the history full of S and Z so the first shape is rarely one of them
+	for (int i = 0; i < HISTORY_SIZE; i++)
+	{
+		state.history[i] = static_cast<std::uint8_t>(i % 2 == 0 ? TetShape::S : TetShape::Z);
+	}
+}
+
+// deal the next shape in the sequence
+// - params: none
+// - return: a TetShape
+TetShape PieceRandomizer::nextShape()
+{
+	int shape = 0;
+	switch (state.mode)
+	{
+	case RandomizerMode::BAG:
+		if (state.bagIndex >= SHAPE_COUNT)
+		{
+			refillBag();
+		}
+		shape = state.bag[state.bagIndex++];
+		break;
+	case RandomizerMode::HISTORY:
+		for (int roll = 0; roll < HISTORY_ROLLS; roll++)
+		{
+			shape = nextBelow(SHAPE_COUNT);
+			bool inHistory = false;
+			for (std::uint8_t recent : state.history)
+			{
+				inHistory = inHistory || recent == shape;
+			}
+			if (!inHistory)
+			{
+				break;
+			}
+		}
+		for (int i = 0; i < HISTORY_SIZE - 1; i++)
+		{
+			state.history[i] = state.history[i + 1];
+		}
+		state.history[HISTORY_SIZE - 1] = static_cast<std::uint8_t>(shape);
+		break;
+	case RandomizerMode::RANDOM:
+	default:
+		shape = nextBelow(SHAPE_COUNT);
+		break;
+	}
+	return static_cast<TetShape>(shape);
+}
+
+RandomizerMode PieceRandomizer::getMode() const
+{
+	return state.mode;
+}
+
+const PieceRandomizer::State& PieceRandomizer::getState() const
+{
+	return state;
+}
+
+void PieceRandomizer::setState(const State& newState)
+{
+	state = newState;
+}
+
+// write the state as a fixed size little-endian record
+// - param 1: the stream to write to
+// - return: nothing
+void PieceRandomizer::writeState(std::ostream& out) const
+{
+	std::uint8_t bytes[SERIALIZED_SIZE];
+	writeState(bytes);
+	out.write(reinterpret_cast<const char*>(bytes), SERIALIZED_SIZE);
+}
+
+// read a state written by writeState()
+// - param 1: the stream to read from
+// - return: true if a complete, valid state was read (the state is unchanged otherwise)
+bool PieceRandomizer::readState(std::istream& in)
+{
+	std::uint8_t bytes[SERIALIZED_SIZE];
+	if (!in.read(reinterpret_cast<char*>(bytes), SERIALIZED_SIZE))
+	{
+		return false;
+	}
+	return readState(bytes);
+}
+
+// write the state record to memory
+// - param 1: a buffer of SERIALIZED_SIZE bytes
+// - return: nothing
+void PieceRandomizer::writeState(std::uint8_t* bytes) const
+{
+	int i = 0;
+	bytes[i++] = static_cast<std::uint8_t>(state.mode);
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		bytes[i++] = static_cast<std::uint8_t>((state.rng >> shift) & 0xFF);
+	}
+	for (std::uint8_t shape : state.bag)
+	{
+		bytes[i++] = shape;
+	}
+	bytes[i++] = state.bagIndex;
+	for (std::uint8_t shape : state.history)
+	{
+		bytes[i++] = shape;
+	}
+}
+
+// read a state record from memory
+// - param 1: a buffer of SERIALIZED_SIZE bytes
+// - return: true if the bytes held a valid state (the state is unchanged otherwise)
+bool PieceRandomizer::readState(const std::uint8_t* bytes)
+{
+	State loaded{};
+	int i = 0;
+	if (bytes[i] >= static_cast<int>(RandomizerMode::COUNT))
+	{
+		return false;	// checked before the cast, an out of range enum value is undefined
+	}
+	loaded.mode = static_cast<RandomizerMode>(bytes[i++]);
+	loaded.rng = 0;
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		loaded.rng |= static_cast<std::uint64_t>(bytes[i++]) << shift;
+	}
+	for (std::uint8_t& shape : loaded.bag)
+	{
+		shape = bytes[i++];
+	}
+	loaded.bagIndex = bytes[i++];
+	for (std::uint8_t& shape : loaded.history)
+	{
+		shape = bytes[i++];
+	}
+	if (!isStateValid(loaded))
+	{
+		return false;
+	}
+	state = loaded;
+	return true;
+}
+
+// whether a State can be dealt from: a known mode, a non-zero rng, and
+// every bag & history entry (and the bag index) in range
+// - param 1: the State
+// - return: bool
+bool PieceRandomizer::isStateValid(const State& state)
+{
+	if (static_cast<int>(state.mode) >= static_cast<int>(RandomizerMode::COUNT) || state.rng == 0
+		|| state.bagIndex > SHAPE_COUNT)
+	{
+		return false;
+	}
+	for (std::uint8_t shape : state.bag)
+	{
+		if (shape >= SHAPE_COUNT)
+		{
+			return false;
+		}
+	}
+	for (std::uint8_t shape : state.history)
+	{
+		if (shape >= SHAPE_COUNT)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// advance the PRNG (xorshift64*)
+// - params: none
+// - return: the next 64 random bits
+std::uint64_t PieceRandomizer::nextRandom()
+{
+	state.rng ^= state.rng >> 12;
+	state.rng ^= state.rng << 25;
+	state.rng ^= state.rng >> 27;
+	return state.rng * 0x2545F4914F6CDD1Dull;
+}
+
+// pick a uniform value in [0, bound)
+// - param 1: the exclusive upper bound
+// - return: a value in [0, bound)
+int PieceRandomizer::nextBelow(int bound)
+{
+	// multiply-shift on the high 32 bits, bias is far below anything measurable for bound <= 7
+	return static_cast<int>(((nextRandom() >> 32) * static_cast<std::uint64_t>(bound)) >> 32);
+}
+
+// shuffle a new bag (Fisher-Yates) and start dealing from the top of it
+// - params: none
+// - return: nothing
+void PieceRandomizer::refillBag()
+{
+	for (int i = 0; i < SHAPE_COUNT; i++)
+	{
+		state.bag[i] = static_cast<std::uint8_t>(i);
+	}
+	for (int i = SHAPE_COUNT - 1; i > 0; i--)
+	{
+		const int j = nextBelow(i + 1);
+		const std::uint8_t temp = state.bag[i];
+		state.bag[i] = state.bag[j];
+		state.bag[j] = temp;
+	}
+	state.bagIndex = 0;
+}
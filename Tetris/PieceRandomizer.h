@@ -0,0 +1,100 @@
+// The PieceRandomizer picks the sequence of tetromino shapes for one game.
+// Each game owns its own randomizer (no global rand() state), so games are
+// reproducible from their seed and can run side by side on many threads.
+//
+// Modes:
+//   RANDOM  - every shape is an independent, uniform pick.
+//   BAG     - "7-bag": deal a shuffled bag of all 7 shapes, then refill.
+//   HISTORY - reroll (up to HISTORY_ROLLS times) any shape found in the
+//             last HISTORY_SIZE shapes dealt.
+//
+// The whole state (mode, PRNG, bag and history) fits in a State struct
+// that can be saved and restored, eg: for replays and keyframes.
+
+#ifndef PIECERANDOMIZER_H
+#define PIECERANDOMIZER_H
+
+#include "Tetromino.h"
+#include <cstdint>
+#include <iosfwd>
+
+enum class RandomizerMode { RANDOM, BAG, HISTORY, COUNT };
+
+class PieceRandomizer
+{
+public:
+	static const int SHAPE_COUNT = static_cast<int>(TetShape::COUNT);
+	static const int HISTORY_SIZE = 4;	// # of recent shapes HISTORY mode avoids
+	static const int HISTORY_ROLLS = 4;	// # of rerolls HISTORY mode makes before accepting a repeat
+
+	// everything needed to continue the exact same sequence
+	struct State
+	{
+		RandomizerMode mode;
+		std::uint64_t rng;						// xorshift64* state (never 0)
+		std::uint8_t bag[SHAPE_COUNT];			// BAG: the current shuffled bag
+		std::uint8_t bagIndex;					// BAG: next bag entry to deal
+		std::uint8_t history[HISTORY_SIZE];		// HISTORY: recently dealt shapes, oldest first
+	};
+
+private:
+	State state;
+
+	// advance the PRNG (xorshift64*)
+	// - params: none
+	// - return: the next 64 random bits
+	std::uint64_t nextRandom();
+
+	// pick a uniform value in [0, bound)
+	// - param 1: the exclusive upper bound
+	// - return: a value in [0, bound)
+	int nextBelow(int bound);
+
+	// shuffle a new bag (Fisher-Yates) and start dealing from the top of it
+	// - params: none
+	// - return: nothing
+	void refillBag();
+
+public:
+	// constructor
+	// - param 1: the seed, the same seed and mode always produce the same shapes
+	// - param 2: the RandomizerMode
+	PieceRandomizer(std::uint64_t seed = 1, RandomizerMode mode = RandomizerMode::BAG);
+
+	// restart the sequence from a seed
+	// - param 1: the seed
+	// - param 2: the RandomizerMode
+	// - return: nothing
+	void reseed(std::uint64_t seed, RandomizerMode mode);
+
+	// deal the next shape in the sequence
+	// - params: none
+	// - return: a TetShape
+	TetShape nextShape();
+
+	RandomizerMode getMode() const;
+
+	// get/set the complete randomizer state
+	const State& getState() const;
+	void setState(const State& newState);
+
+	// whether a State can be dealt from: a known mode, a non-zero rng, and
+	// every bag & history entry (and the bag index) in range
+	// - param 1: the State
+	// - return: bool
+	static bool isStateValid(const State& state);
+
+	// write/read the state as a fixed size little-endian record
+	// (SERIALIZED_SIZE bytes, independent of the platform's struct layout)
+	static const int SERIALIZED_SIZE = 1 + 8 + SHAPE_COUNT + 1 + HISTORY_SIZE;
+	void writeState(std::ostream& out) const;
+	bool readState(std::istream& in);
+
+	// the same record, to/from memory
+	// - param 1: a buffer of (at least) SERIALIZED_SIZE bytes
+	// - return: (read) true if the bytes held a valid state (the state is unchanged otherwise)
+	void writeState(std::uint8_t* bytes) const;
+	bool readState(const std::uint8_t* bytes);
+};
+
+#endif /* PIECERANDOMIZER_H */
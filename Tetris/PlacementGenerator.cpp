@@ -0,0 +1,95 @@
+#include "PlacementGenerator.h"
+#include "TetrisSimulation.h"
+#include <algorithm>
+
+// list every distinct placement of a shape, spawning at the board's spawn location
+// - param 1: the Gameboard
+// - param 2: the TetShape to place
+// - param 3: the PlacementList to fill in
+// - return: the number of placements found
+int PlacementGenerator::generate(const Gameboard& board, TetShape shape, PlacementList& placements)
+{
+	unsigned long long keys[MAX_PLACEMENTS];
+	placements.count = 0;
+
+	GridTetromino spawned;
+	spawned.setShape(shape);
+	spawned.setGridLoc(board.getSpawnLoc());
+
+	for (int rotation = 0; rotation < Tetromino::ROTATION_COUNT; rotation++)
+	{
+		// each rotation is made from the previous one at the spawn location
+		if (rotation > 0)
+		{
+			spawned.rotateClockwise();
+		}
+		if (!TetrisSimulation::isPositionLegal(board, spawned))
+		{
+			break;
+		}
+
+		// slide out to each side of the spawn location until something is in the way
+		for (int direction = -1; direction <= 1; direction += 2)
+		{
+			GridTetromino slid{ spawned };
+			if (direction == 1)
+			{
+				slid.move(1, 0);	// the spawn column itself was covered going left
+			}
+			while (TetrisSimulation::isPositionLegal(board, slid))
+			{
+				GridTetromino landed{ slid };
+				landed.move(0, TetrisSimulation::getDropDistance(board, landed));
+
+				const unsigned long long key = getCellKey(landed);
+				if (std::find(keys, keys + placements.count, key) == keys + placements.count)
+				{
+					keys[placements.count] = key;
+					placements.placements[placements.count++] =
+						Placement{ landed.getGridLoc().getX(), landed.getGridLoc().getY(), rotation };
+				}
+				slid.move(direction, 0);
+			}
+		}
+	}
+	return placements.count;
+}
+
+// set a GridTetromino to a placement
+// - param 1: the TetShape
+// - param 2: the Placement
+// - return: a GridTetromino at the placement's gridLoc and rotation
+GridTetromino PlacementGenerator::toGridTetromino(TetShape shape, const Placement& placement)
+{
+	GridTetromino placed;
+	placed.setShape(shape);
+	for (int i = 0; i < placement.rotation; i++)
+	{
+		placed.rotateClockwise();
+	}
+	placed.setGridLoc(placement.x, placement.y);
+	return placed;
+}
+
+// a key identifying the cells a shape covers (independent of rotation)
+// - param 1: the GridTetromino
+// - return: the shape's sorted cell indices packed into 64 bits
+unsigned long long PlacementGenerator::getCellKey(const GridTetromino& shape)
+{
+	// shapes may hang above the top of the board, so offset the rows to keep indices positive
+	const int ROW_OFFSET = 4;
+	unsigned int cells[Tetromino::BLOCK_COUNT];
+	const BlockLocs locs = shape.getBlockLocsMappedToGrid();
+	for (int i = 0; i < Tetromino::BLOCK_COUNT; i++)
+	{
+		cells[i] = static_cast<unsigned int>((locs[i].getY() + ROW_OFFSET) * Gameboard::MAX_X + locs[i].getX());
+	}
+	std::sort(cells, cells + Tetromino::BLOCK_COUNT);
+
+	unsigned long long key = 0;
+	for (unsigned int cell : cells)
+	{
+		key = (key << 16) | cell;
+	}
+	return key;
+}
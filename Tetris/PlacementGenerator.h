@@ -0,0 +1,58 @@
+// The PlacementGenerator answers "where can this piece land?".
+// Given a gameboard and a shape it lists every distinct final resting
+// placement the shape can hard drop into: rotate at the spawn location,
+// slide left or right along the spawn row, then drop.
+// Legality is decided by TetrisSimulation::isPositionLegal(), so the
+// generator always agrees with the game.
+//
+// Placements that cover the same cells are only listed once, so the
+// symmetric rotations of O, I, S and Z don't produce duplicates.
+// Nothing is allocated: results go into a fixed size PlacementList.
+
+#ifndef PLACEMENTGENERATOR_H
+#define PLACEMENTGENERATOR_H
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+
+// a final resting position: the gridLoc and rotation of the shape once it has landed
+struct Placement
+{
+	int x;
+	int y;
+	int rotation;
+};
+
+class PlacementGenerator
+{
+public:
+	// at most one placement per rotation per column
+	static const int MAX_PLACEMENTS = Tetromino::ROTATION_COUNT * Gameboard::MAX_X;
+
+	struct PlacementList
+	{
+		int count{ 0 };
+		Placement placements[MAX_PLACEMENTS];
+	};
+
+	// list every distinct placement of a shape, spawning at the board's spawn location
+	// - param 1: the Gameboard
+	// - param 2: the TetShape to place
+	// - param 3: the PlacementList to fill in
+	// - return: the number of placements found
+	static int generate(const Gameboard& board, TetShape shape, PlacementList& placements);
+
+	// set a GridTetromino to a placement
+	// - param 1: the TetShape
+	// - param 2: the Placement
+	// - return: a GridTetromino at the placement's gridLoc and rotation
+	static GridTetromino toGridTetromino(TetShape shape, const Placement& placement);
+
+	// a key identifying the cells a shape covers (independent of rotation)
+	//   (also used by ReachabilitySearch to de-duplicate its lock positions)
+	// - param 1: the GridTetromino
+	// - return: the shape's sorted cell indices packed into 64 bits
+	static unsigned long long getCellKey(const GridTetromino& shape);
+};
+
+#endif /* PLACEMENTGENERATOR_H */
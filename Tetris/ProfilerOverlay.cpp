@@ -0,0 +1,104 @@
+#include "ProfilerOverlay.h"
+#include <iomanip>
+#include <sstream>
+
+const std::chrono::nanoseconds ProfilerOverlay::REFRESH_INTERVAL{ std::chrono::milliseconds(250) };
+
+// constructor, hidden
+// - param 1: the FrameProfiler to show
+// - param 2: the position of its top left corner in the window
+ProfilerOverlay::ProfilerOverlay(FrameProfiler& profiler, const sf::Vector2f& position)
+	: profiler(profiler)
+{
+	background.setPosition(position);
+	background.setFillColor(sf::Color(0, 0, 0, 180));
+	text.setCharacterSize(CHARACTER_SIZE);
+	text.setFillColor(sf::Color::White);
+	text.setPosition(position + sf::Vector2f(6, 4));
+}
+
+// load the font for the text
+// - param 1: the font file path
+// - return: false if it couldn't be loaded
+bool ProfilerOverlay::loadFont(const std::string& path)
+{
+	if (!font.loadFromFile(path))
+	{
+		return false;
+	}
+	text.setFont(font);
+	return true;
+}
+
+// show it if hidden, hide it if shown
+// - params: none
+// - return: nothing
+void ProfilerOverlay::toggle()
+{
+	visible = !visible;
+	nextRefreshTime = FrameProfiler::Clock::time_point();	// refresh on the next update()
+}
+
+// - return: whether it's shown
+bool ProfilerOverlay::isVisible() const
+{
+	return visible;
+}
+
+// refresh the text if it's shown and REFRESH_INTERVAL has passed
+// - param 1: the current time
+// - return: true if the text changed (the window needs redrawing)
+bool ProfilerOverlay::update(FrameProfiler::Clock::time_point now)
+{
+	if (!visible || now < nextRefreshTime)
+	{
+		return false;
+	}
+	refresh(now);
+	nextRefreshTime = now + REFRESH_INTERVAL;
+	return true;
+}
+
+// - return: when update() will next refresh the text (time_point::max() while hidden)
+FrameProfiler::Clock::time_point ProfilerOverlay::getNextRefreshTime() const
+{
+	return visible ? nextRefreshTime : FrameProfiler::Clock::time_point::max();
+}
+
+// draw it, if it's shown
+// - param 1: where to draw it
+// - return: nothing
+void ProfilerOverlay::draw(sf::RenderTarget& target) const
+{
+	if (visible)
+	{
+		target.draw(background);
+		target.draw(text);
+	}
+}
+
+// rebuild the text from the profiler's recent statistics
+// - param 1: the current time
+// - return: nothing
+void ProfilerOverlay::refresh(FrameProfiler::Clock::time_point now)
+{
+	const auto toMicroseconds = [](std::chrono::nanoseconds time) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+	};
+
+	std::ostringstream lines;
+	lines << std::left << std::setw(12) << "us" << std::right
+		<< std::setw(8) << "p50" << std::setw(8) << "p99" << std::setw(8) << "max";
+	for (int i = 0; i < profiler.getSectionCount(); i++)
+	{
+		const FrameProfiler::Stats stats = profiler.getRecentStats(i, now);
+		lines << "\n" << std::left << std::setw(12) << profiler.getSectionName(i) << std::right
+			<< std::setw(8) << toMicroseconds(stats.p50)
+			<< std::setw(8) << toMicroseconds(stats.p99)
+			<< std::setw(8) << toMicroseconds(stats.max);
+	}
+	text.setString(lines.str());
+
+	const sf::FloatRect bounds = text.getLocalBounds();
+	background.setSize(sf::Vector2f(bounds.left + bounds.width + 12, bounds.top + bounds.height + 12));
+}
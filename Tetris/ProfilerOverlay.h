@@ -0,0 +1,68 @@
+// The ProfilerOverlay draws a FrameProfiler's recent statistics over the
+// game window: p50, p99 & max of each section, in microseconds.
+// It's toggled on and off (with F3, by main()), and while it's shown its text
+// is refreshed every REFRESH_INTERVAL, so reading the statistics doesn't
+// cost a lock per section every frame.
+
+#ifndef PROFILEROVERLAY_H
+#define PROFILEROVERLAY_H
+
+#include "FrameProfiler.h"
+#include <chrono>
+#include <string>
+#include <SFML/Graphics.hpp>
+
+class ProfilerOverlay
+{
+public:
+	static const std::chrono::nanoseconds REFRESH_INTERVAL;	// init to 250 ms
+	static const unsigned int CHARACTER_SIZE = 14;
+
+private:
+	FrameProfiler& profiler;
+	sf::Font font;
+	sf::Text text;
+	sf::RectangleShape background;	// darkens the game behind the text
+	bool visible{ false };
+	FrameProfiler::Clock::time_point nextRefreshTime;
+
+public:
+	// constructor, hidden
+	// - param 1: the FrameProfiler to show
+	// - param 2: the position of its top left corner in the window
+	ProfilerOverlay(FrameProfiler& profiler, const sf::Vector2f& position);
+
+	// load the font for the text
+	// - param 1: the font file path
+	// - return: false if it couldn't be loaded
+	bool loadFont(const std::string& path);
+
+	// show it if hidden, hide it if shown
+	// - params: none
+	// - return: nothing
+	void toggle();
+
+	// - return: whether it's shown
+	bool isVisible() const;
+
+	// refresh the text if it's shown and REFRESH_INTERVAL has passed
+	// - param 1: the current time
+	// - return: true if the text changed (the window needs redrawing)
+	bool update(FrameProfiler::Clock::time_point now);
+
+	// - return: when update() will next refresh the text (time_point::max() while hidden)
+	FrameProfiler::Clock::time_point getNextRefreshTime() const;
+
+	// draw it, if it's shown
+	// - param 1: where to draw it
+	// - return: nothing
+	void draw(sf::RenderTarget& target) const;
+
+private:
+	// rebuild the text from the profiler's recent statistics
+	// - param 1: the current time
+	// - return: nothing
+	void refresh(FrameProfiler::Clock::time_point now);
+};
+
+#endif /* PROFILEROVERLAY_H */
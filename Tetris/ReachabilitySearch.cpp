@@ -0,0 +1,160 @@
+#include "ReachabilitySearch.h"
+#include <algorithm>
+
+namespace
+{
+	// the inputs that move a piece without locking it, in the order they are tried
+	const GameInput MOVES[] = { GameInput::LEFT, GameInput::RIGHT, GameInput::ROTATE, GameInput::SOFT_DROP };
+}
+
+// the state index of a gridLoc & rotation
+// - param 1: the gridLoc x
+// - param 2: the gridLoc y
+// - param 3: the rotation
+// - return: the index, or NO_STATE if the gridLoc is off the board
+int ReachabilitySearch::toStateIndex(int x, int y, int rotation)
+{
+	if (x < 0 || x >= Gameboard::MAX_X || y < 0 || y >= Gameboard::MAX_Y)
+	{
+		return NO_STATE;
+	}
+	return (rotation * Gameboard::MAX_Y + y) * Gameboard::MAX_X + x;
+}
+
+// the GridTetromino a state index stands for
+// - param 1: the TetShape
+// - param 2: a state index from toStateIndex()
+// - return: a GridTetromino at the state's gridLoc and rotation
+GridTetromino ReachabilitySearch::fromStateIndex(TetShape shape, int state)
+{
+	const int x = state % Gameboard::MAX_X;
+	const int y = (state / Gameboard::MAX_X) % Gameboard::MAX_Y;
+	const int rotation = state / (Gameboard::MAX_X * Gameboard::MAX_Y);
+	return PlacementGenerator::toGridTetromino(shape, Placement{ x, y, rotation });
+}
+
+// search from the spawn location (rotation 0 at the board's spawn loc)
+// - param 1: the Gameboard
+// - param 2: the TetShape
+// - return: the number of distinct lock positions found
+int ReachabilitySearch::search(const Gameboard& board, TetShape shape)
+{
+	GridTetromino start;
+	start.setShape(shape);
+	start.setGridLoc(board.getSpawnLoc());
+	return search(board, start);
+}
+
+// search every lock position reachable from a starting position
+// - param 1: the Gameboard
+// - param 2: the starting GridTetromino
+// - return: the number of distinct lock positions found
+int ReachabilitySearch::search(const Gameboard& board, const GridTetromino& start)
+{
+	visited.reset();
+	resultCount = 0;
+	searchedShape = start.getShape();
+
+	const int startState = toStateIndex(start.getGridLoc().getX(), start.getGridLoc().getY(), start.getRotation());
+	if (startState == NO_STATE || !TetrisSimulation::isPositionLegal(board, start))
+	{
+		return 0;
+	}
+
+	int head = 0;
+	int tail = 0;
+	visited.set(startState);
+	parent[startState] = NO_STATE;
+	queue[tail++] = static_cast<std::int16_t>(startState);
+
+	while (head < tail)
+	{
+		const int state = queue[head++];
+		const GridTetromino current = fromStateIndex(searchedShape, state);
+
+		// HARD_DROP locks the piece where it lands. BFS pops states in order of
+		// distance, so the first state to land on a position is the shortest.
+		GridTetromino landed{ current };
+		landed.move(0, TetrisSimulation::getDropDistance(board, landed));
+		const unsigned long long key = PlacementGenerator::getCellKey(landed);
+		if (std::find(resultKeys, resultKeys + resultCount, key) == resultKeys + resultCount)
+		{
+			resultKeys[resultCount] = key;
+			resultLockedFrom[resultCount] = static_cast<std::int16_t>(state);
+			results[resultCount++] = Placement{ landed.getGridLoc().getX(), landed.getGridLoc().getY(), landed.getRotation() };
+		}
+
+		for (GameInput input : MOVES)
+		{
+			GridTetromino next{ current };
+			switch (input)
+			{
+			case GameInput::LEFT:
+				next.move(-1, 0);
+				break;
+			case GameInput::RIGHT:
+				next.move(1, 0);
+				break;
+			case GameInput::ROTATE:
+				next.rotateClockwise();
+				break;
+			default:
+				next.move(0, 1);
+				break;
+			}
+			const int nextState = toStateIndex(next.getGridLoc().getX(), next.getGridLoc().getY(), next.getRotation());
+			if (nextState == NO_STATE || visited.test(nextState) || !TetrisSimulation::isPositionLegal(board, next))
+			{
+				continue;
+			}
+			visited.set(nextState);
+			parent[nextState] = static_cast<std::int16_t>(state);
+			parentInput[nextState] = input;
+			queue[tail++] = static_cast<std::int16_t>(nextState);
+		}
+	}
+	return resultCount;
+}
+
+// - return: the number of lock positions the last search() found
+int ReachabilitySearch::getResultCount() const
+{
+	return resultCount;
+}
+
+// a lock position the last search() found
+// - param 1: the result index, 0 to getResultCount() - 1
+// - return: the Placement
+const Placement& ReachabilitySearch::getResult(int index) const
+{
+	return results[index];
+}
+
+// the shortest input sequence locking the piece at a result
+// - param 1: the result index
+// - param 2: an array to write the inputs to (in the order they are pressed)
+// - param 3: the capacity of that array
+// - return: the number of inputs in the sequence
+int ReachabilitySearch::getPath(int index, GameInput inputs[], int maxInputs) const
+{
+	// count the moves back to the start, then fill the array back to front
+	int length = 1;		// the final HARD_DROP
+	for (int state = resultLockedFrom[index]; parent[state] != NO_STATE; state = parent[state])
+	{
+		length++;
+	}
+	int position = length - 1;
+	if (position < maxInputs)
+	{
+		inputs[position] = GameInput::HARD_DROP;
+	}
+	for (int state = resultLockedFrom[index]; parent[state] != NO_STATE; state = parent[state])
+	{
+		position--;
+		if (position < maxInputs)
+		{
+			inputs[position] = parentInput[state];
+		}
+	}
+	return length;
+}
@@ -0,0 +1,90 @@
+// The ReachabilitySearch finds every position a tetromino can be locked in
+// using the real controls (TetrisSimulation::applyInput()), including
+// soft-drop tucks under overhangs, slides and late rotations that a plain
+// hard drop (PlacementGenerator) can't reach.
+//
+// It is a breadth first search over (x, y, rotation) states. Each input is
+// applied the same way attemptMove() / attemptRotate() do, so no state is
+// reached that the game would refuse. Gravity is ignored (inputs are assumed
+// to arrive faster than ticks).
+//
+// For each distinct lock position (by the cells it covers) the shortest
+// input sequence that locks the piece there is kept; the sequence always
+// ends with the HARD_DROP that locks it.
+// All storage is fixed size (a visited bitset and an array queue), so a
+// search never allocates. Keep one instance around and reuse it.
+
+#ifndef REACHABILITYSEARCH_H
+#define REACHABILITYSEARCH_H
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "PlacementGenerator.h"
+#include "TetrisSimulation.h"
+#include <bitset>
+#include <cstdint>
+
+class ReachabilitySearch
+{
+public:
+	// every (x, y, rotation) a legally placed gridLoc can have
+	static const int STATE_COUNT = Tetromino::ROTATION_COUNT * Gameboard::MAX_Y * Gameboard::MAX_X;
+	static const int NO_STATE = -1;
+
+private:
+	std::bitset<STATE_COUNT> visited;
+	std::int16_t queue[STATE_COUNT];			// BFS queue, each state is pushed at most once
+	std::int16_t parent[STATE_COUNT];			// the state each visited state was reached from
+	GameInput parentInput[STATE_COUNT];			// the input that reached it
+
+	int resultCount{ 0 };
+	Placement results[STATE_COUNT];				// the lock positions found
+	std::int16_t resultLockedFrom[STATE_COUNT];	// the state the locking HARD_DROP was pressed in
+	unsigned long long resultKeys[STATE_COUNT];	// the cells each result covers (for de-duplication)
+	TetShape searchedShape{ TetShape::T };
+
+	// the state index of a gridLoc & rotation
+	// - param 1: the gridLoc x
+	// - param 2: the gridLoc y
+	// - param 3: the rotation
+	// - return: the index, or NO_STATE if the gridLoc is off the board
+	static int toStateIndex(int x, int y, int rotation);
+
+	// the GridTetromino a state index stands for
+	// - param 1: the TetShape
+	// - param 2: a state index from toStateIndex()
+	// - return: a GridTetromino at the state's gridLoc and rotation
+	static GridTetromino fromStateIndex(TetShape shape, int state);
+
+public:
+	// search every lock position reachable from a starting position
+	// - param 1: the Gameboard
+	// - param 2: the starting GridTetromino (eg: the game's currentShape,
+	//            must be at a legal position on the board)
+	// - return: the number of distinct lock positions found
+	int search(const Gameboard& board, const GridTetromino& start);
+
+	// search from the spawn location (rotation 0 at the board's spawn loc)
+	// - param 1: the Gameboard
+	// - param 2: the TetShape
+	// - return: the number of distinct lock positions found
+	int search(const Gameboard& board, TetShape shape);
+
+	// - return: the number of lock positions the last search() found
+	int getResultCount() const;
+
+	// a lock position the last search() found
+	// - param 1: the result index, 0 to getResultCount() - 1
+	// - return: the Placement
+	const Placement& getResult(int index) const;
+
+	// the shortest input sequence locking the piece at a result
+	// - param 1: the result index
+	// - param 2: an array to write the inputs to (in the order they are pressed)
+	// - param 3: the capacity of that array
+	// - return: the number of inputs in the sequence (may exceed param 3, only
+	//           that many are written)
+	int getPath(int index, GameInput inputs[], int maxInputs) const;
+};
+
+#endif /* REACHABILITYSEARCH_H */
@@ -0,0 +1,290 @@
+#include "ReplayFormat.h"
+#include <algorithm>
+#include <cstring>
+
+const char ReplayFormat::MAGIC[4]{ 'T', 'R', 'P', 'L' };
+const char ReplayFormat::INDEX_MAGIC[4]{ 'T', 'R', 'P', 'I' };
+
+// encode a varint
+// - param 1: the value
+// - param 2: a buffer with room for MAX_VARINT_SIZE bytes
+// - return: the number of bytes written
+int ReplayFormat::writeVarint(std::uint64_t value, std::uint8_t* buffer)
+{
+	int size = 0;
+	while (value >= 0x80)
+	{
+		buffer[size++] = static_cast<std::uint8_t>(value | 0x80);
+		value >>= 7;
+	}
+	buffer[size++] = static_cast<std::uint8_t>(value);
+	return size;
+}
+
+// decode a varint
+// - param 1: in/out, the read position, advanced past the varint
+// - param 2: the end of the data
+// - param 3: out, the value
+// - return: false if the data ended (or overflowed 64 bits) mid varint
+bool ReplayFormat::readVarint(const std::uint8_t*& position, const std::uint8_t* end, std::uint64_t& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64 && position != end; shift += 7)
+	{
+		const std::uint8_t byte = *position++;
+		value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// encode a little-endian 64 bit value
+void ReplayFormat::writeFixed64(std::uint64_t value, std::uint8_t* buffer)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		buffer[i] = static_cast<std::uint8_t>(value >> (8 * i));
+	}
+}
+
+// decode a little-endian 64 bit value
+std::uint64_t ReplayFormat::readFixed64(const std::uint8_t* buffer)
+{
+	std::uint64_t value = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		value |= static_cast<std::uint64_t>(buffer[i]) << (8 * i);
+	}
+	return value;
+}
+
+namespace
+{
+	// zigzag maps small negative numbers to small varints (0, -1, 1, -2 ... -> 0, 1, 2, 3 ...)
+	std::uint64_t toZigzag(int value)
+	{
+		return value < 0 ? (static_cast<std::uint64_t>(-(value + 1)) << 1) | 1 : static_cast<std::uint64_t>(value) << 1;
+	}
+
+	int fromZigzag(std::uint64_t value)
+	{
+		return (value & 1) ? -static_cast<int>(value >> 1) - 1 : static_cast<int>(value >> 1);
+	}
+}
+
+// encode a keyframe payload
+// - param 1: the simulation State
+// - param 2: a buffer with room for MAX_KEYFRAME_SIZE bytes
+// - return: the number of bytes written
+int ReplayFormat::writeKeyframe(const TetrisSimulation::State& state, std::uint8_t* buffer)
+{
+	// the body is written after room for its byte count (always 1 or 2 varint bytes), then moved up if need be
+	std::uint8_t* body = buffer + 2;
+	int size = 0;
+
+	std::uint8_t* bitplane = body;
+	std::fill(bitplane, bitplane + BITPLANE_SIZE, 0);
+	size += BITPLANE_SIZE;
+	int colorCount = 0;
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			const int content = state.cells[y][x];
+			if (content == Gameboard::EMPTY_BLOCK)
+			{
+				continue;
+			}
+			const int bit = y * Gameboard::MAX_X + x;
+			bitplane[bit / 8] |= static_cast<std::uint8_t>(1 << (bit % 8));
+			if (colorCount % 2 == 0)
+			{
+				body[size++] = static_cast<std::uint8_t>(content & 0x0F);
+			}
+			else {
+				body[size - 1] |= static_cast<std::uint8_t>((content & 0x0F) << 4);
+			}
+			colorCount++;
+		}
+	}
+
+	body[size++] = static_cast<std::uint8_t>(state.currentShape);
+	body[size++] = static_cast<std::uint8_t>(state.currentRotation);
+	size += writeVarint(toZigzag(state.currentX), body + size);
+	size += writeVarint(toZigzag(state.currentY), body + size);
+	body[size++] = static_cast<std::uint8_t>(state.nextShape);
+	body[size++] = state.awaitingSpawn ? 1 : 0;
+	size += writeVarint(toZigzag(state.lockedRowsTop), body + size);
+	size += writeVarint(toZigzag(state.lockedRowsBottom), body + size);
+	size += writeVarint(toZigzag(state.score), body + size);
+	size += writeVarint(toZigzag(state.linesCleared), body + size);
+	size += writeVarint(toZigzag(state.piecesLocked), body + size);
+	size += writeVarint(toZigzag(state.gamesLost), body + size);
+	size += writeVarint(state.loopCount, body + size);
+
+	PieceRandomizer randomizer;
+	randomizer.setState(state.randomizer);
+	randomizer.writeState(body + size);
+	size += PieceRandomizer::SERIALIZED_SIZE;
+
+	std::uint8_t sizeBytes[MAX_VARINT_SIZE];
+	const int sizeLength = writeVarint(static_cast<std::uint64_t>(size), sizeBytes);
+	std::memmove(buffer + sizeLength, body, static_cast<std::size_t>(size));
+	std::copy(sizeBytes, sizeBytes + sizeLength, buffer);
+	return sizeLength + size;
+}
+
+// decode a keyframe payload
+// - param 1: in/out, the read position, advanced past the payload
+// - param 2: the end of the data
+// - param 3: out, the State
+// - return: false if the payload is truncated or invalid
+bool ReplayFormat::readKeyframe(const std::uint8_t*& position, const std::uint8_t* end, TetrisSimulation::State& state)
+{
+	std::uint64_t size = 0;
+	if (!readVarint(position, end, size) || size > static_cast<std::uint64_t>(end - position) || size < BITPLANE_SIZE)
+	{
+		return false;
+	}
+	const std::uint8_t* body = position;
+	const std::uint8_t* bodyEnd = position + size;
+	position = bodyEnd;
+
+	const std::uint8_t* bitplane = body;
+	const std::uint8_t* at = body + BITPLANE_SIZE;
+	int colorCount = 0;
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			const int bit = y * Gameboard::MAX_X + x;
+			if ((bitplane[bit / 8] & (1 << (bit % 8))) == 0)
+			{
+				state.cells[y][x] = static_cast<signed char>(Gameboard::EMPTY_BLOCK);
+				continue;
+			}
+			if (colorCount % 2 == 0)
+			{
+				if (at == bodyEnd)
+				{
+					return false;
+				}
+				state.cells[y][x] = static_cast<signed char>(*at++ & 0x0F);
+			}
+			else {
+				state.cells[y][x] = static_cast<signed char>(at[-1] >> 4);
+			}
+			colorCount++;
+		}
+	}
+
+	std::uint64_t values[11];
+	if (bodyEnd - at < 2)
+	{
+		return false;
+	}
+	const std::uint8_t shape = *at++;
+	const std::uint8_t rotation = *at++;
+	if (!readVarint(at, bodyEnd, values[0]) || !readVarint(at, bodyEnd, values[1]) || bodyEnd - at < 2)
+	{
+		return false;
+	}
+	const std::uint8_t nextShape = *at++;
+	const std::uint8_t awaitingSpawn = *at++;
+	for (int i = 2; i < 9; i++)
+	{
+		if (!readVarint(at, bodyEnd, values[i]))
+		{
+			return false;
+		}
+	}
+	for (int i = 0; i < 8; i++)
+	{
+		if (values[i] > 0xFFFFFFFFull)
+		{
+			return false;	// not the zigzag of an int
+		}
+	}
+	PieceRandomizer randomizer;
+	if (shape >= static_cast<int>(TetShape::COUNT) || nextShape >= static_cast<int>(TetShape::COUNT)
+		|| bodyEnd - at < PieceRandomizer::SERIALIZED_SIZE || !randomizer.readState(at))
+	{
+		return false;
+	}
+
+	state.currentShape = static_cast<TetShape>(shape);
+	state.currentRotation = rotation % Tetromino::ROTATION_COUNT;
+	state.currentX = fromZigzag(values[0]);
+	state.currentY = fromZigzag(values[1]);
+	state.nextShape = static_cast<TetShape>(nextShape);
+	state.awaitingSpawn = awaitingSpawn != 0;
+	state.lockedRowsTop = fromZigzag(values[2]);
+	state.lockedRowsBottom = fromZigzag(values[3]);
+	state.score = fromZigzag(values[4]);
+	state.linesCleared = fromZigzag(values[5]);
+	state.piecesLocked = fromZigzag(values[6]);
+	state.gamesLost = fromZigzag(values[7]);
+	state.loopCount = values[8];
+	state.randomizer = randomizer.getState();
+	return TetrisSimulation::isStateValid(state);
+}
+
+// find the last keyframe at or before a loop, using the index at the end of a replay
+// - param 1: the replay bytes
+// - param 2: the byte count
+// - param 3: the target loop
+// - param 4: out, the keyframe's loop
+// - param 5: out, the offset of the keyframe's payload
+// - return: false if there is no index or no keyframe at or before the loop
+bool ReplayFormat::findKeyframe(const std::uint8_t* data, std::size_t size, unsigned long long loop,
+	unsigned long long& keyframeLoop, std::size_t& offset)
+{
+	if (size < FOOTER_SIZE)
+	{
+		return false;
+	}
+	const std::uint8_t* footer = data + size - FOOTER_SIZE;
+	if (!std::equal(INDEX_MAGIC, INDEX_MAGIC + sizeof(INDEX_MAGIC), reinterpret_cast<const char*>(footer + 12)))
+	{
+		return false;
+	}
+	const std::uint64_t indexOffset = readFixed64(footer);
+	const std::uint64_t count = static_cast<std::uint64_t>(footer[8]) | static_cast<std::uint64_t>(footer[9]) << 8
+		| static_cast<std::uint64_t>(footer[10]) << 16 | static_cast<std::uint64_t>(footer[11]) << 24;
+	if (indexOffset > size - FOOTER_SIZE || count > (size - FOOTER_SIZE - indexOffset) / INDEX_ENTRY_SIZE)
+	{
+		return false;
+	}
+
+	// the first entry after the target, then step back one
+	const std::uint8_t* index = data + indexOffset;
+	std::uint64_t low = 0;
+	std::uint64_t high = count;
+	while (low < high)
+	{
+		const std::uint64_t middle = low + (high - low) / 2;
+		if (readFixed64(index + middle * INDEX_ENTRY_SIZE) <= loop)
+		{
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	if (low == 0)
+	{
+		return false;
+	}
+	const std::uint8_t* entry = index + (low - 1) * INDEX_ENTRY_SIZE;
+	keyframeLoop = readFixed64(entry);
+	const std::uint64_t payloadOffset = readFixed64(entry + 8);
+	if (payloadOffset >= indexOffset)
+	{
+		return false;
+	}
+	offset = static_cast<std::size_t>(payloadOffset);
+	return true;
+}
@@ -0,0 +1,106 @@
+// The layout of a replay file, shared by ReplayRecorder and ReplayPlayer.
+//
+// A replay is the randomizer seed plus every input and gravity tick, each
+// stamped with the game loop it happened in (TetrisSimulation::getLoopCount()):
+//
+//   header:  "TRPL", version byte, varint seed, randomizer mode byte
+//   records: varint (loopDelta << 3 | code)
+//              code 0-4: a GameInput applied in that loop
+//              code 5:   the loop's gravity tick (always the loop's last record)
+//              code 6:   KEYFRAME, the game state at the start of that loop (see below)
+//              code 7:   END, followed by varint final score, varint board hash
+//   index:   (version 2) one fixed size entry per keyframe, in loop order:
+//              u64 loop, u64 file offset of the keyframe's payload
+//   footer:  (version 2) the last FOOTER_SIZE bytes of the file:
+//              u64 index offset, u32 entry count, "TRPI"
+//
+// loopDelta is the number of loops since the previous record, so a normal
+// game costs about one byte per event. A gravity tick is recorded at least
+// every MAX_SECONDS_PER_TICK, so real gaps are short: a loopDelta over
+// MAX_LOOP_DELTA is treated as a damaged (or crafted) replay.
+// Varints are little-endian base 128 (7 bits per byte, high bit = more follows),
+// fixed size values are little-endian.
+//
+// A keyframe payload is a varint byte count, then:
+//   the board bitplane (1 bit per block, row by row, MAX_Y * MAX_X bits),
+//   the color of each set block (4 bits each, in bitplane order),
+//   current shape, rotation, zigzag x, zigzag y, next shape,
+//   awaiting spawn flag, zigzag locked rows top & bottom,
+//   varint score, lines, pieces, games lost, loop count,
+//   the PieceRandomizer state record.
+// Seeking binary searches the index for the last keyframe at or before the
+// target loop, restores it and re-simulates the records after it, so the
+// cost of a seek is the records since that keyframe, not since the start.
+// (ReplayPlayer still loads the whole replay into memory, a replay is only
+// a few bytes per second of play.)
+
+#ifndef REPLAYFORMAT_H
+#define REPLAYFORMAT_H
+
+#include "TetrisSimulation.h"
+#include <cstddef>
+#include <cstdint>
+
+class ReplayFormat
+{
+public:
+	static const char MAGIC[4];
+	static const char INDEX_MAGIC[4];
+	static const std::uint8_t VERSION = 2;
+	static const std::uint8_t FIRST_VERSION = 1;	// version 1: no keyframes or index
+
+	static const int CODE_BITS = 3;
+	static const int CODE_MASK = (1 << CODE_BITS) - 1;
+	static const int GRAVITY_TICK = static_cast<int>(GameInput::COUNT);	// 5
+	static const int KEYFRAME = 6;
+	static const int END = 7;
+	static const unsigned long long MAX_LOOP_DELTA = 1ull << 16;	// the most loops between two records
+
+	static const int MAX_VARINT_SIZE = 10;	// bytes in the longest 64 bit varint
+	static const int BITPLANE_SIZE = (Gameboard::MAX_Y * Gameboard::MAX_X + 7) / 8;
+	static const int MAX_KEYFRAME_SIZE = 256;	// bytes in the largest keyframe payload (with its byte count)
+	static const int INDEX_ENTRY_SIZE = 16;
+	static const int FOOTER_SIZE = 16;
+
+	// encode a varint
+	// - param 1: the value
+	// - param 2: a buffer with room for MAX_VARINT_SIZE bytes
+	// - return: the number of bytes written
+	static int writeVarint(std::uint64_t value, std::uint8_t* buffer);
+
+	// decode a varint
+	// - param 1: in/out, the read position, advanced past the varint
+	// - param 2: the end of the data
+	// - param 3: out, the value
+	// - return: false if the data ended (or overflowed 64 bits) mid varint
+	static bool readVarint(const std::uint8_t*& position, const std::uint8_t* end, std::uint64_t& value);
+
+	// encode / decode a little-endian 64 bit value
+	static void writeFixed64(std::uint64_t value, std::uint8_t* buffer);
+	static std::uint64_t readFixed64(const std::uint8_t* buffer);
+
+	// encode a keyframe payload
+	// - param 1: the simulation State
+	// - param 2: a buffer with room for MAX_KEYFRAME_SIZE bytes
+	// - return: the number of bytes written
+	static int writeKeyframe(const TetrisSimulation::State& state, std::uint8_t* buffer);
+
+	// decode a keyframe payload
+	// - param 1: in/out, the read position, advanced past the payload
+	// - param 2: the end of the data
+	// - param 3: out, the State
+	// - return: false if the payload is truncated or invalid (see TetrisSimulation::isStateValid())
+	static bool readKeyframe(const std::uint8_t*& position, const std::uint8_t* end, TetrisSimulation::State& state);
+
+	// find the last keyframe at or before a loop, using the index at the end of a replay
+	// - param 1: the replay bytes
+	// - param 2: the byte count
+	// - param 3: the target loop
+	// - param 4: out, the keyframe's loop
+	// - param 5: out, the offset of the keyframe's payload
+	// - return: false if there is no index or no keyframe at or before the loop
+	static bool findKeyframe(const std::uint8_t* data, std::size_t size, unsigned long long loop,
+		unsigned long long& keyframeLoop, std::size_t& offset);
+};
+
+#endif /* REPLAYFORMAT_H */
@@ -0,0 +1,219 @@
+#include "ReplayPlayer.h"
+#include "ReplayFormat.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+// read a replay file into memory
+// - param 1: the file path
+// - return: false if it couldn't be read or isn't a replay
+bool ReplayPlayer::load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		data.clear();
+		headerValid = false;
+		return false;
+	}
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return parseHeader();
+}
+
+// use a replay that is already in memory (copied)
+// - param 1: the replay bytes
+// - param 2: the byte count
+// - return: false if it isn't a replay
+bool ReplayPlayer::load(const std::uint8_t* bytes, std::size_t size)
+{
+	data.assign(bytes, bytes + size);
+	return parseHeader();
+}
+
+// check the header and remember the seed & mode
+bool ReplayPlayer::parseHeader()
+{
+	headerValid = false;
+	const std::uint8_t* position = data.data();
+	const std::uint8_t* end = position + data.size();
+	if (data.size() < sizeof(ReplayFormat::MAGIC) + 1
+		|| !std::equal(ReplayFormat::MAGIC, ReplayFormat::MAGIC + sizeof(ReplayFormat::MAGIC), reinterpret_cast<const char*>(position)))
+	{
+		return false;
+	}
+	position += sizeof(ReplayFormat::MAGIC);
+	const std::uint8_t version = *position++;
+	if (version < ReplayFormat::FIRST_VERSION || version > ReplayFormat::VERSION || !ReplayFormat::readVarint(position, end, seed) || position == end)
+	{
+		return false;
+	}
+	const std::uint8_t modeByte = *position++;
+	if (modeByte >= static_cast<std::uint8_t>(RandomizerMode::COUNT))
+	{
+		return false;
+	}
+	mode = static_cast<RandomizerMode>(modeByte);
+	recordsOffset = static_cast<std::size_t>(position - data.data());
+	headerValid = true;
+	return true;
+}
+
+std::uint64_t ReplayPlayer::getSeed() const
+{
+	return seed;
+}
+
+RandomizerMode ReplayPlayer::getMode() const
+{
+	return mode;
+}
+
+// replay the game on a simulation and verify how it ended
+// - param 1: the TetrisSimulation to play on
+// - return: OK if the replay ended with the recorded score and board
+ReplayPlayer::Result ReplayPlayer::play(TetrisSimulation& simulation) const
+{
+	if (!headerValid)
+	{
+		return data.empty() ? Result::UNREADABLE : Result::BAD_FORMAT;
+	}
+	simulation.newGame(seed, mode);
+	return run(simulation, data.data() + recordsOffset, 0, NO_STOP);
+}
+
+// put a simulation in the state the game had at the start of a loop
+// - param 1: the TetrisSimulation
+// - param 2: the loop
+// - return: OK, or why the replay couldn't be followed that far
+ReplayPlayer::Result ReplayPlayer::seek(TetrisSimulation& simulation, unsigned long long loop) const
+{
+	if (!headerValid)
+	{
+		return data.empty() ? Result::UNREADABLE : Result::BAD_FORMAT;
+	}
+	simulation.newGame(seed, mode);
+
+	unsigned long long keyframeLoop = 0;
+	std::size_t offset = 0;
+	if (!ReplayFormat::findKeyframe(data.data(), data.size(), loop, keyframeLoop, offset) || offset < recordsOffset)
+	{
+		return run(simulation, data.data() + recordsOffset, 0, loop);
+	}
+	const std::uint8_t* position = data.data() + offset;
+	TetrisSimulation::State state;
+	if (!ReplayFormat::readKeyframe(position, data.data() + data.size(), state) || state.loopCount != keyframeLoop
+		|| !simulation.restoreState(state))
+	{
+		return Result::BAD_FORMAT;
+	}
+	return run(simulation, position, keyframeLoop, loop);
+}
+
+// play records into a simulation
+// - param 1: the TetrisSimulation, at the state the records start from
+// - param 2: the first record
+// - param 3: the loop the previous record happened in
+// - param 4: stop at the start of this loop (NO_STOP: play to the END and verify it)
+// - return: OK, or why the replay couldn't be followed
+ReplayPlayer::Result ReplayPlayer::run(TetrisSimulation& simulation, const std::uint8_t* position, unsigned long long loop,
+	unsigned long long stopLoop) const
+{
+	const std::uint8_t* end = data.data() + data.size();
+	std::uint64_t record = 0;
+	while (ReplayFormat::readVarint(position, end, record))
+	{
+		const int code = static_cast<int>(record & ReplayFormat::CODE_MASK);
+		const std::uint64_t loopDelta = record >> ReplayFormat::CODE_BITS;
+		if (loopDelta > ReplayFormat::MAX_LOOP_DELTA)
+		{
+			return Result::BAD_FORMAT;	// more idle loops than a game can have, don't run them
+		}
+		loop += loopDelta;
+
+		// run the loops before this one (without gravity, it would have been recorded).
+		// The first one settles any shape locked by the previous loop's inputs.
+		while (simulation.getLoopCount() < loop && simulation.getLoopCount() < stopLoop)
+		{
+			simulation.stepGameLoop(false);
+		}
+		if (loop >= stopLoop)
+		{
+			return Result::OK;
+		}
+
+		if (code < static_cast<int>(GameInput::COUNT))
+		{
+			simulation.applyInput(static_cast<GameInput>(code));
+		}
+		else if (code == ReplayFormat::GRAVITY_TICK)
+		{
+			simulation.stepGameLoop(true);
+		}
+		else if (code == ReplayFormat::KEYFRAME)
+		{
+			// the recorded state must match the re-simulated one byte for byte
+			const std::uint8_t* payload = position;
+			TetrisSimulation::State recorded;
+			if (!ReplayFormat::readKeyframe(position, end, recorded))
+			{
+				return Result::TRUNCATED;
+			}
+			TetrisSimulation::State replayed;
+			simulation.saveState(replayed);
+			std::uint8_t encoded[ReplayFormat::MAX_KEYFRAME_SIZE];
+			const int size = ReplayFormat::writeKeyframe(replayed, encoded);
+			if (size != position - payload || !std::equal(encoded, encoded + size, payload))
+			{
+				return Result::KEYFRAME_MISMATCH;
+			}
+		}
+		else if (code == ReplayFormat::END)
+		{
+			if (stopLoop != NO_STOP)
+			{
+				return Result::OK;		// seeking past the end stops at the end
+			}
+			std::uint64_t score = 0;
+			std::uint64_t boardHash = 0;
+			if (!ReplayFormat::readVarint(position, end, score) || !ReplayFormat::readVarint(position, end, boardHash))
+			{
+				return Result::TRUNCATED;
+			}
+			if (static_cast<std::uint64_t>(simulation.getScore()) != score)
+			{
+				return Result::SCORE_MISMATCH;
+			}
+			return simulation.getBoard().getContentHash() == boardHash ? Result::OK : Result::BOARD_MISMATCH;
+		}
+		else {
+			return Result::BAD_FORMAT;		// an unknown record code
+		}
+	}
+	return Result::TRUNCATED;
+}
+
+// a readable name for a Result
+// - param 1: the Result
+// - return: the name
+const char* ReplayPlayer::toString(Result result)
+{
+	switch (result)
+	{
+	case Result::OK:
+		return "OK";
+	case Result::UNREADABLE:
+		return "unreadable";
+	case Result::BAD_FORMAT:
+		return "bad format";
+	case Result::TRUNCATED:
+		return "truncated";
+	case Result::SCORE_MISMATCH:
+		return "score mismatch";
+	case Result::BOARD_MISMATCH:
+		return "board mismatch";
+	case Result::KEYFRAME_MISMATCH:
+		return "keyframe mismatch";
+	default:
+		return "unknown";
+	}
+}
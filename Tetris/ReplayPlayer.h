@@ -0,0 +1,81 @@
+// The ReplayPlayer re-simulates a replay file (see ReplayFormat.h) headless
+// and checks that it ends with the recorded score and board.
+//
+// Nothing is drawn and no time passes: the recorded inputs and gravity
+// ticks are fed straight to TetrisSimulation::applyInput() / stepGameLoop(),
+// so a replay plays back as fast as the simulation can run.
+// seek() restores the nearest keyframe before a loop and re-simulates
+// only the rest, for scrubbing through long games. load() reads the whole
+// replay into memory, the keyframe index saves simulating, not reading.
+// A player can be reused: load() another replay and play() it again.
+
+#ifndef REPLAYPLAYER_H
+#define REPLAYPLAYER_H
+
+#include "PieceRandomizer.h"
+#include "TetrisSimulation.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ReplayPlayer
+{
+public:
+	enum class Result { OK, UNREADABLE, BAD_FORMAT, TRUNCATED, SCORE_MISMATCH, BOARD_MISMATCH, KEYFRAME_MISMATCH };
+	static const unsigned long long NO_STOP = ~0ull;
+
+private:
+	std::vector<std::uint8_t> data;		// the whole replay
+	std::size_t recordsOffset{ 0 };		// where the records start (after the header)
+	std::uint64_t seed{ 0 };
+	RandomizerMode mode{ RandomizerMode::BAG };
+	bool headerValid{ false };
+
+	// check the header and remember the seed & mode
+	bool parseHeader();
+
+	// play records into a simulation
+	// - param 1: the TetrisSimulation, at the state the records start from
+	// - param 2: the first record
+	// - param 3: the loop the previous record happened in
+	// - param 4: stop at the start of this loop (NO_STOP: play to the END and verify it)
+	// - return: OK, or why the replay couldn't be followed
+	Result run(TetrisSimulation& simulation, const std::uint8_t* position, unsigned long long loop, unsigned long long stopLoop) const;
+
+public:
+	// read a replay file into memory
+	// - param 1: the file path
+	// - return: false if it couldn't be read or isn't a replay
+	bool load(const std::string& path);
+
+	// use a replay that is already in memory (copied)
+	// - param 1: the replay bytes
+	// - param 2: the byte count
+	// - return: false if it isn't a replay
+	bool load(const std::uint8_t* bytes, std::size_t size);
+
+	std::uint64_t getSeed() const;
+	RandomizerMode getMode() const;
+
+	// replay the game on a simulation and verify how it ended
+	// - param 1: the TetrisSimulation to play on (newGame() is called on it, it shouldn't be recording)
+	// - return: OK if the replay ended with the recorded score and board
+	Result play(TetrisSimulation& simulation) const;
+
+	// put a simulation in the state the game had at the start of a loop
+	//   (after the previous loop ran, before that loop's inputs).
+	//   Starts from the last keyframe at or before the loop, or from the
+	//   beginning if there is none. Seeking past the END stops at the END.
+	// - param 1: the TetrisSimulation (newGame() is called on it, it shouldn't be recording)
+	// - param 2: the loop
+	// - return: OK, or why the replay couldn't be followed that far
+	Result seek(TetrisSimulation& simulation, unsigned long long loop) const;
+
+	// a readable name for a Result
+	// - param 1: the Result
+	// - return: the name
+	static const char* toString(Result result);
+};
+
+#endif /* REPLAYPLAYER_H */
@@ -0,0 +1,166 @@
+#include "ReplayRecorder.h"
+#include "ReplayFormat.h"
+#include <cassert>
+
+// destructor - close() without an END record if still open
+ReplayRecorder::~ReplayRecorder()
+{
+	close();
+}
+
+// create the file and write the header
+// - param 1: the file path (replaced if it exists)
+// - param 2: the game's randomizer seed
+// - param 3: the game's RandomizerMode
+// - return: false if the file couldn't be created
+bool ReplayRecorder::open(const std::string& path, std::uint64_t seed, RandomizerMode mode)
+{
+	close();
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		return false;
+	}
+	bufferUsed = 0;
+	lastLoop = 0;
+	flushedSize = 0;
+	keyframes.clear();
+	lastKeyframeLoop = 0;
+	for (char c : ReplayFormat::MAGIC)
+	{
+		buffer[bufferUsed++] = static_cast<std::uint8_t>(c);
+	}
+	buffer[bufferUsed++] = ReplayFormat::VERSION;
+	bufferUsed += ReplayFormat::writeVarint(seed, buffer + bufferUsed);
+	buffer[bufferUsed++] = static_cast<std::uint8_t>(mode);
+	return true;
+}
+
+bool ReplayRecorder::isOpen() const
+{
+	return file.is_open();
+}
+
+// called by TetrisSimulation
+// - param 1: the game loop the event happened in
+// - param 2: the GameInput
+// - return: nothing
+void ReplayRecorder::recordInput(unsigned long long loop, GameInput input)
+{
+	writeRecord(loop, static_cast<int>(input));
+}
+
+void ReplayRecorder::recordGravityTick(unsigned long long loop)
+{
+	writeRecord(loop, ReplayFormat::GRAVITY_TICK);
+}
+
+// called by TetrisSimulation at the end of each game loop, records a keyframe when one is due
+// - param 1: the simulation being recorded
+// - return: nothing
+void ReplayRecorder::recordLoopEnd(const TetrisSimulation& simulation)
+{
+	const unsigned long long loop = simulation.getLoopCount();
+	if (!isOpen() || keyframeInterval == 0 || loop - lastKeyframeLoop < keyframeInterval)
+	{
+		return;
+	}
+	TetrisSimulation::State state;
+	simulation.saveState(state);
+	writeRecord(loop, ReplayFormat::KEYFRAME);
+	keyframes.push_back(IndexEntry{ loop, flushedSize + static_cast<std::uint64_t>(bufferUsed) });
+	bufferUsed += ReplayFormat::writeKeyframe(state, buffer + bufferUsed);
+	lastKeyframeLoop = loop;
+}
+
+// the number of game loops between keyframes (0: no keyframes)
+// - param 1: the interval
+// - return: nothing
+void ReplayRecorder::setKeyframeInterval(unsigned long long loops)
+{
+	keyframeInterval = loops;
+}
+
+// write the END record (final score & board hash) and close the file
+// - param 1: the simulation being recorded
+// - return: false if any write failed
+bool ReplayRecorder::finish(const TetrisSimulation& simulation)
+{
+	if (!isOpen())
+	{
+		return false;
+	}
+	writeRecord(simulation.getLoopCount(), ReplayFormat::END);
+	bufferUsed += ReplayFormat::writeVarint(static_cast<std::uint64_t>(simulation.getScore()), buffer + bufferUsed);
+	bufferUsed += ReplayFormat::writeVarint(simulation.getBoard().getContentHash(), buffer + bufferUsed);
+	writeIndex();
+	flush();
+	const bool written = static_cast<bool>(file);
+	file.close();
+	return written;
+}
+
+// close the file without an END record
+// - return: nothing
+void ReplayRecorder::close()
+{
+	if (isOpen())
+	{
+		flush();
+		file.close();
+	}
+}
+
+// append one record (flushing the buffer first if it might not fit)
+void ReplayRecorder::writeRecord(unsigned long long loop, int code)
+{
+	if (!isOpen())
+	{
+		return;
+	}
+	// room for the record plus a keyframe, or an END's score & hash
+	if (bufferUsed > BUFFER_SIZE - ReplayFormat::MAX_VARINT_SIZE - ReplayFormat::MAX_KEYFRAME_SIZE)
+	{
+		flush();
+	}
+	const std::uint64_t delta = loop - lastLoop;
+	assert(delta <= ReplayFormat::MAX_LOOP_DELTA && "ReplayRecorder records too far apart to play back");
+	lastLoop = loop;
+	bufferUsed += ReplayFormat::writeVarint((delta << ReplayFormat::CODE_BITS) | static_cast<std::uint64_t>(code), buffer + bufferUsed);
+}
+
+// append the keyframe index and footer
+void ReplayRecorder::writeIndex()
+{
+	const std::uint64_t indexOffset = flushedSize + static_cast<std::uint64_t>(bufferUsed);
+	for (const IndexEntry& entry : keyframes)
+	{
+		if (bufferUsed > BUFFER_SIZE - ReplayFormat::INDEX_ENTRY_SIZE)
+		{
+			flush();
+		}
+		ReplayFormat::writeFixed64(entry.loop, buffer + bufferUsed);
+		ReplayFormat::writeFixed64(entry.offset, buffer + bufferUsed + 8);
+		bufferUsed += ReplayFormat::INDEX_ENTRY_SIZE;
+	}
+	if (bufferUsed > BUFFER_SIZE - ReplayFormat::FOOTER_SIZE)
+	{
+		flush();
+	}
+	const std::uint32_t count = static_cast<std::uint32_t>(keyframes.size());
+	ReplayFormat::writeFixed64(indexOffset, buffer + bufferUsed);
+	for (int i = 0; i < 4; i++)
+	{
+		buffer[bufferUsed + 8 + i] = static_cast<std::uint8_t>(count >> (8 * i));
+		buffer[bufferUsed + 12 + i] = static_cast<std::uint8_t>(ReplayFormat::INDEX_MAGIC[i]);
+	}
+	bufferUsed += ReplayFormat::FOOTER_SIZE;
+}
+
+// write the buffer to the file
+void ReplayRecorder::flush()
+{
+	file.write(reinterpret_cast<const char*>(buffer), bufferUsed);
+	flushedSize += static_cast<std::uint64_t>(bufferUsed);
+	bufferUsed = 0;
+}
@@ -0,0 +1,95 @@
+// The ReplayRecorder writes a replay file (see ReplayFormat.h) while a game is played.
+//
+// Attach it with TetrisSimulation::setRecorder() right after newGame():
+// the simulation then reports every applyInput() and gravity tick, whoever
+// made them (the keyboard or the bot).
+// Records are gathered in a fixed buffer and written out in large blocks,
+// so recording costs no file I/O on most game loops.
+// Every keyframe interval a keyframe (the whole game state) is recorded too,
+// and finish() appends their index, so ReplayPlayer::seek() can jump close
+// to any point of a long game.
+
+#ifndef REPLAYRECORDER_H
+#define REPLAYRECORDER_H
+
+#include "PieceRandomizer.h"
+#include "TetrisSimulation.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class ReplayRecorder
+{
+public:
+	static const int BUFFER_SIZE = 4096;
+	static const unsigned long long DEFAULT_KEYFRAME_INTERVAL = 300;	// game loops (3 seconds of 10 ms TickScheduler steps)
+
+private:
+	std::ofstream file;
+	std::uint8_t buffer[BUFFER_SIZE];
+	int bufferUsed{ 0 };
+	unsigned long long lastLoop{ 0 };	// the loop of the previous record
+	std::uint64_t flushedSize{ 0 };		// bytes already written to the file
+
+	struct IndexEntry
+	{
+		unsigned long long loop;
+		std::uint64_t offset;			// of the keyframe's payload
+	};
+	std::vector<IndexEntry> keyframes;
+	unsigned long long keyframeInterval{ DEFAULT_KEYFRAME_INTERVAL };
+	unsigned long long lastKeyframeLoop{ 0 };
+
+	// append one record (flushing the buffer first if it might not fit)
+	void writeRecord(unsigned long long loop, int code);
+	// append the keyframe index and footer
+	void writeIndex();
+	// write the buffer to the file
+	void flush();
+
+public:
+	ReplayRecorder() = default;
+	ReplayRecorder(const ReplayRecorder&) = delete;
+	ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+	// destructor - close() without an END record if still open
+	~ReplayRecorder();
+
+	// create the file and write the header
+	// - param 1: the file path (replaced if it exists)
+	// - param 2: the game's randomizer seed
+	// - param 3: the game's RandomizerMode
+	// - return: false if the file couldn't be created
+	bool open(const std::string& path, std::uint64_t seed, RandomizerMode mode);
+
+	bool isOpen() const;
+
+	// called by TetrisSimulation
+	// - param 1: the game loop the event happened in
+	// - param 2: (recordInput) the GameInput
+	// - return: nothing
+	void recordInput(unsigned long long loop, GameInput input);
+	void recordGravityTick(unsigned long long loop);
+
+	// called by TetrisSimulation at the end of each game loop, records a keyframe when one is due
+	// - param 1: the simulation being recorded
+	// - return: nothing
+	void recordLoopEnd(const TetrisSimulation& simulation);
+
+	// the number of game loops between keyframes (0: no keyframes)
+	// - param 1: the interval
+	// - return: nothing
+	void setKeyframeInterval(unsigned long long loops);
+
+	// write the END record (final score & board hash) and the keyframe index, and close the file
+	// - param 1: the simulation being recorded (the loop count, score & board are read from it)
+	// - return: false if any write failed
+	bool finish(const TetrisSimulation& simulation);
+
+	// close the file without an END record (the replay can't be verified)
+	// - return: nothing
+	void close();
+};
+
+#endif /* REPLAYRECORDER_H */
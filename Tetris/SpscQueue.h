@@ -0,0 +1,65 @@
+// A lock-free, fixed capacity, single producer / single consumer queue.
+//
+// One thread push()es and one thread pop()s. Each side only writes its own
+// index (tail for the producer, head for the consumer) and reads the other's,
+// so neither ever blocks. The indices count up forever and wrap by CAPACITY.
+// The items live in the queue itself, so it never allocates.
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+
+template <typename T, unsigned int CAPACITY>
+class SpscQueue
+{
+private:
+	T items[CAPACITY];
+	alignas(64) std::atomic<unsigned int> head{ 0 };	// the next item to pop, written by the consumer
+	alignas(64) std::atomic<unsigned int> tail{ 0 };	// the next slot to push, written by the producer
+
+public:
+	SpscQueue() = default;
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// producer: add an item to the back
+	// - param 1: the item
+	// - return: false if the queue was full (the item isn't added)
+	bool push(const T& item)
+	{
+		const unsigned int back = tail.load(std::memory_order_relaxed);
+		if (back - head.load(std::memory_order_acquire) == CAPACITY)
+		{
+			return false;
+		}
+		items[back % CAPACITY] = item;
+		tail.store(back + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer: take the item at the front
+	// - param 1: set to the item
+	// - return: false if the queue was empty
+	bool pop(T& item)
+	{
+		const unsigned int front = head.load(std::memory_order_relaxed);
+		if (front == tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		item = items[front % CAPACITY];
+		head.store(front + 1, std::memory_order_release);
+		return true;
+	}
+
+	// either side: whether there's nothing queued (may be stale by the time it returns)
+	// - params: none
+	// - return: bool
+	bool isEmpty() const
+	{
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+};
+
+#endif /* SPSCQUEUE_H */
@@ -0,0 +1,151 @@
+#include "TaskPool.h"
+
+// constructor - start the worker threads
+// - param 1: the number of worker threads (besides the calling thread)
+TaskPool::TaskPool(unsigned int workerCount)
+{
+	for (unsigned int i = 0; i <= workerCount; i++)
+	{
+		queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+	}
+	for (unsigned int i = 1; i <= workerCount; i++)
+	{
+		workers.emplace_back(&TaskPool::workerLoop, this, static_cast<int>(i));
+	}
+}
+
+// destructor - stop & join the worker threads
+TaskPool::~TaskPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		stopping = true;
+	}
+	wakeCondition.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+// one worker per core, less the calling thread
+// - return: the default worker count
+unsigned int TaskPool::getDefaultWorkerCount()
+{
+	const unsigned int cores = std::thread::hardware_concurrency();
+	return cores > 1 ? cores - 1 : 0;
+}
+
+// - return: the number of worker threads
+unsigned int TaskPool::getWorkerCount() const
+{
+	return static_cast<unsigned int>(workers.size());
+}
+
+// deal the tasks out, help run them, and wait for the rest
+void TaskPool::run(int count, void (*function)(void*, int), void* context)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> runLock(runMutex);
+	pendingCount = count;
+
+	const int queueCount = static_cast<int>(queues.size());
+	int queued = 0;
+	for (int index = 0; index < count; index++)
+	{
+		TaskQueue& queue = *queues[index % queueCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.back - queue.front == QUEUE_CAPACITY)
+		{
+			break;		// every queue is full, the caller runs the rest below
+		}
+		queue.tasks[queue.back++ % QUEUE_CAPACITY] = Task{ function, context, index };
+		queued++;
+	}
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		queuedCount += queued;
+	}
+	wakeCondition.notify_all();
+
+	for (int index = queued; index < count; index++)
+	{
+		execute(Task{ function, context, index });
+	}
+
+	// help out until nothing is left to take, then wait for the stragglers
+	Task task;
+	while (popTask(0, task) || stealTask(0, task))
+	{
+		execute(task);
+	}
+	std::unique_lock<std::mutex> lock(doneMutex);
+	doneCondition.wait(lock, [this] { return pendingCount == 0; });
+}
+
+// the worker thread body
+// - param 1: the worker's queue index
+void TaskPool::workerLoop(int queueIndex)
+{
+	Task task;
+	while (true)
+	{
+		if (popTask(queueIndex, task) || stealTask(queueIndex, task))
+		{
+			execute(task);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		wakeCondition.wait(lock, [this] { return stopping || queuedCount > 0; });
+		if (stopping && queuedCount == 0)
+		{
+			return;
+		}
+	}
+}
+
+// take the newest task from a queue
+bool TaskPool::popTask(int queueIndex, Task& task)
+{
+	TaskQueue& queue = *queues[queueIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.back == queue.front)
+	{
+		return false;
+	}
+	task = queue.tasks[--queue.back % QUEUE_CAPACITY];
+	queuedCount--;
+	return true;
+}
+
+// take the oldest task from any other queue
+bool TaskPool::stealTask(int thiefIndex, Task& task)
+{
+	const int queueCount = static_cast<int>(queues.size());
+	for (int offset = 1; offset < queueCount; offset++)
+	{
+		TaskQueue& queue = *queues[(thiefIndex + offset) % queueCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.back != queue.front)
+		{
+			task = queue.tasks[queue.front++ % QUEUE_CAPACITY];
+			queuedCount--;
+			return true;
+		}
+	}
+	return false;
+}
+
+// run a task and count it as finished
+void TaskPool::execute(const Task& task)
+{
+	task.function(task.context, task.index);
+	if (--pendingCount == 0)
+	{
+		std::lock_guard<std::mutex> lock(doneMutex);
+		doneCondition.notify_all();
+	}
+}
@@ -0,0 +1,107 @@
+// A small work-stealing thread pool for splitting a loop across every core.
+//
+// parallelFor() deals the loop indices round-robin onto one queue per thread
+// (the workers plus the calling thread, which helps out rather than blocking).
+// Each thread runs its own queue newest first, and when it runs dry steals
+// the oldest task from another queue, so uneven tasks still balance out.
+//
+// Tasks are plain (function, context, index) records in fixed size ring
+// buffers, so dealing out work doesn't allocate.
+// parallelFor() calls are serialized, and the function must not throw.
+
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskPool
+{
+public:
+	static const int QUEUE_CAPACITY = 256;	// tasks per queue, extra tasks are run by the caller
+
+	// constructor - start the worker threads
+	// - param 1: the number of worker threads (besides the calling thread),
+	//            0 runs every parallelFor() on the calling thread
+	explicit TaskPool(unsigned int workerCount = getDefaultWorkerCount());
+
+	// destructor - stop & join the worker threads
+	~TaskPool();
+
+	TaskPool(const TaskPool&) = delete;
+	TaskPool& operator=(const TaskPool&) = delete;
+
+	// one worker per core, less the calling thread
+	// - return: the default worker count
+	static unsigned int getDefaultWorkerCount();
+
+	// - return: the number of worker threads
+	unsigned int getWorkerCount() const;
+
+	// call function(index) for every index in [0, count) and wait for them all
+	// - param 1: int the number of indices
+	// - param 2: the function (or lambda) to call, it must be safe to call
+	//            from several threads at once
+	// - return: nothing
+	template <typename Function>
+	void parallelFor(int count, Function& function)
+	{
+		run(count, &invoke<Function>, &function);
+	}
+
+private:
+	struct Task
+	{
+		void (*function)(void* context, int index);
+		void* context;
+		int index;
+	};
+
+	// a ring buffer of tasks: the owner pops from the back, thieves from the front
+	struct TaskQueue
+	{
+		std::mutex mutex;
+		Task tasks[QUEUE_CAPACITY];
+		unsigned int front{ 0 };
+		unsigned int back{ 0 };
+	};
+
+	std::vector<std::unique_ptr<TaskQueue>> queues;	// [0] is the calling thread's, then one per worker
+	std::vector<std::thread> workers;
+
+	std::atomic<int> queuedCount{ 0 };		// tasks sitting in queues
+	std::atomic<int> pendingCount{ 0 };		// tasks not yet finished
+	bool stopping{ false };					// guarded by wakeMutex
+
+	std::mutex runMutex;					// serializes parallelFor() calls
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;	// signalled when tasks are queued or on shutdown
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;	// signalled when pendingCount reaches 0
+
+	template <typename Function>
+	static void invoke(void* context, int index)
+	{
+		(*static_cast<Function*>(context))(index);
+	}
+
+	// deal the tasks out, help run them, and wait for the rest
+	void run(int count, void (*function)(void*, int), void* context);
+
+	// the worker thread body
+	// - param 1: the worker's queue index
+	void workerLoop(int queueIndex);
+
+	// take a task from a queue's back (own) / front (steal)
+	bool popTask(int queueIndex, Task& task);
+	bool stealTask(int thiefIndex, Task& task);
+
+	// run a task and count it as finished
+	void execute(const Task& task);
+};
+
+#endif /* TASKPOOL_H */
@@ -0,0 +1,177 @@
+#include "TetrisBot.h"
+#include "PlacementGenerator.h"
+#include <algorithm>
+#include <cstdlib>
+
+// a board the next shape can't be placed on (the game is lost)
+static const double GAME_OVER_SCORE = -1.0e9;
+
+// tuned weights from the well known 4 feature player, with a light well penalty
+const TetrisBot::Weights TetrisBot::DEFAULT_WEIGHTS{ { -0.510066, 0.760666, -0.35663, -0.184483, -0.05 } };
+
+// constructor
+// - param 1: the TaskPool to evaluate on, or nullptr to run single threaded
+// - param 2: the feature Weights
+TetrisBot::TetrisBot(TaskPool* pool, const Weights& weights)
+	: pool{ pool }, weights(weights)
+{
+}
+
+const TetrisBot::Weights& TetrisBot::getWeights() const
+{
+	return weights;
+}
+
+void TetrisBot::setWeights(const Weights& weights)
+{
+	this->weights = weights;
+}
+
+// find the best placement of the simulation's current shape
+// - param 1: the TetrisSimulation (not modified)
+// - param 2: an array to write the input sequence to
+// - param 3: the capacity of that array
+// - return: the number of inputs written, 0 if the current shape can't be placed
+int TetrisBot::plan(const TetrisSimulation& simulation, GameInput inputs[], int maxInputs)
+{
+	const Gameboard& board = simulation.getBoard();
+	const TetShape shape = simulation.getCurrentShape().getShape();
+	const TetShape nextShape = simulation.getNextShape().getShape();
+	const int placementCount = search.search(board, simulation.getCurrentShape());
+
+	auto evaluateOne = [&](int index) {
+		scores[index] = evaluatePlacement(board, PlacementGenerator::toGridTetromino(shape, search.getResult(index)), nextShape);
+	};
+	if (pool != nullptr)
+	{
+		pool->parallelFor(placementCount, evaluateOne);
+	}
+	else {
+		for (int index = 0; index < placementCount; index++)
+		{
+			evaluateOne(index);
+		}
+	}
+
+	int best = -1;
+	for (int index = 0; index < placementCount; index++)
+	{
+		if (best < 0 || scores[index] > scores[best])
+		{
+			best = index;
+		}
+	}
+	if (best < 0)
+	{
+		return 0;
+	}
+	return std::min(search.getPath(best, inputs, maxInputs), maxInputs);
+}
+
+// plan() and apply the inputs to the simulation, locking the current shape.
+// - param 1: the TetrisSimulation
+// - return: true if a shape was placed
+bool TetrisBot::play(TetrisSimulation& simulation)
+{
+	if (simulation.isAwaitingSpawn())
+	{
+		return false;
+	}
+	GameInput inputs[MAX_PLAN_LENGTH];
+	const int length = plan(simulation, inputs, MAX_PLAN_LENGTH);
+	for (int i = 0; i < length; i++)
+	{
+		simulation.applyInput(inputs[i]);
+	}
+	return length > 0;
+}
+
+// measure a board's features
+// - param 1: the Gameboard
+// - param 2: the number of lines cleared getting there
+// - param 3: an array of FEATURE_COUNT values to fill in
+// - return: nothing
+void TetrisBot::getFeatures(const Gameboard& board, int linesCleared, double features[FEATURE_COUNT])
+{
+	int heights[Gameboard::MAX_X];
+	int aggregateHeight = 0;
+	for (int x = 0; x < Gameboard::MAX_X; x++)
+	{
+		heights[x] = board.getColumnHeight(x);
+		aggregateHeight += heights[x];
+	}
+
+	// every filled block is at or below its column's top, the rest of that space is holes
+	int filled = 0;
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		filled += board.getRowFillCount(y);
+	}
+
+	int bumpiness = 0;
+	int wells = 0;
+	for (int x = 0; x < Gameboard::MAX_X; x++)
+	{
+		if (x + 1 < Gameboard::MAX_X)
+		{
+			bumpiness += std::abs(heights[x] - heights[x + 1]);
+		}
+		// the walls count as infinitely tall neighbours
+		const int left = x > 0 ? heights[x - 1] : Gameboard::MAX_Y;
+		const int right = x + 1 < Gameboard::MAX_X ? heights[x + 1] : Gameboard::MAX_Y;
+		wells += std::max(0, std::min(left, right) - heights[x]);
+	}
+
+	features[AGGREGATE_HEIGHT] = aggregateHeight;
+	features[COMPLETED_LINES] = linesCleared;
+	features[HOLES] = aggregateHeight - filled;
+	features[BUMPINESS] = bumpiness;
+	features[WELLS] = wells;
+}
+
+// the weighted sum of a board's features (higher is better)
+// - param 1: the Gameboard
+// - param 2: the number of lines cleared getting there
+// - param 3: the Weights
+// - return: the score
+double TetrisBot::evaluate(const Gameboard& board, int linesCleared, const Weights& weights)
+{
+	double features[FEATURE_COUNT];
+	getFeatures(board, linesCleared, features);
+	double score = 0.0;
+	for (int i = 0; i < FEATURE_COUNT; i++)
+	{
+		score += weights.values[i] * features[i];
+	}
+	return score;
+}
+
+// score the best follow up after locking a first-ply shape
+// - param 1: the Gameboard before the lock
+// - param 2: the first-ply shape at its lock position
+// - param 3: the next TetShape
+// - return: the best score over the next shape's placements
+double TetrisBot::evaluatePlacement(const Gameboard& board, const GridTetromino& placed, TetShape nextShape) const
+{
+	Gameboard firstPly{ board };
+	firstPly.setContent(placed.getBlockLocsMappedToGrid(), static_cast<int>(placed.getColor()));
+	const int firstLines = firstPly.removeCompletedRows();
+
+	PlacementGenerator::PlacementList placements;
+	PlacementGenerator::generate(firstPly, nextShape, placements);
+	if (placements.count == 0)
+	{
+		return GAME_OVER_SCORE + evaluate(firstPly, firstLines, weights);
+	}
+
+	double best = GAME_OVER_SCORE;
+	for (int i = 0; i < placements.count; i++)
+	{
+		const GridTetromino next = PlacementGenerator::toGridTetromino(nextShape, placements.placements[i]);
+		Gameboard secondPly{ firstPly };
+		secondPly.setContent(next.getBlockLocsMappedToGrid(), static_cast<int>(next.getColor()));
+		const int secondLines = secondPly.removeCompletedRows();
+		best = std::max(best, evaluate(secondPly, firstLines + secondLines, weights));
+	}
+	return best;
+}
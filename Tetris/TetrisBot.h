@@ -0,0 +1,89 @@
+// The TetrisBot is a built-in AI player.
+//
+// For every position the current shape can reach (ReachabilitySearch) it
+// locks a copy of the board, then tries every hard drop placement of the
+// next shape (PlacementGenerator) on that, and scores the resulting boards
+// with a weighted sum of classic features:
+//   aggregate height, completed lines, holes, bumpiness and wells.
+// The best first placement wins (ties go to the first one found, so a
+// game played by the bot is deterministic).
+//
+// The first-ply placements are evaluated in parallel on a TaskPool.
+// The bot plays by calling TetrisSimulation::applyInput() with the input
+// sequence the search found, the same calls a player's key presses make.
+
+#ifndef TETRISBOT_H
+#define TETRISBOT_H
+
+#include "Gameboard.h"
+#include "ReachabilitySearch.h"
+#include "TaskPool.h"
+#include "TetrisSimulation.h"
+
+class TetrisBot
+{
+public:
+	// the board features the bot scores
+	enum Feature { AGGREGATE_HEIGHT, COMPLETED_LINES, HOLES, BUMPINESS, WELLS, FEATURE_COUNT };
+
+	// one weight per Feature, a board's score is the weighted sum of its features
+	struct Weights
+	{
+		double values[FEATURE_COUNT];
+	};
+
+	static const Weights DEFAULT_WEIGHTS;
+	static const int MAX_PLAN_LENGTH = ReachabilitySearch::STATE_COUNT;
+
+private:
+	TaskPool* pool;				// spreads the first ply across cores (nullptr: evaluate on the calling thread)
+	Weights weights;
+	ReachabilitySearch search;	// the current shape's reachable lock positions
+	double scores[ReachabilitySearch::STATE_COUNT];	// the best score following each of them
+
+public:
+	// constructor
+	// - param 1: the TaskPool to evaluate on, or nullptr to run single threaded
+	// - param 2: the feature Weights
+	explicit TetrisBot(TaskPool* pool = nullptr, const Weights& weights = DEFAULT_WEIGHTS);
+
+	const Weights& getWeights() const;
+	void setWeights(const Weights& weights);
+
+	// find the best placement of the simulation's current shape
+	// - param 1: the TetrisSimulation (not modified)
+	// - param 2: an array to write the input sequence to
+	// - param 3: the capacity of that array
+	// - return: the number of inputs written, 0 if the current shape can't be placed
+	int plan(const TetrisSimulation& simulation, GameInput inputs[], int maxInputs);
+
+	// plan() and apply the inputs to the simulation, locking the current shape.
+	// Does nothing while a locked shape is waiting for processGameLoop() to spawn the next one.
+	// - param 1: the TetrisSimulation
+	// - return: true if a shape was placed
+	bool play(TetrisSimulation& simulation);
+
+	// measure a board's features
+	// - param 1: the Gameboard
+	// - param 2: the number of lines cleared getting there
+	// - param 3: an array of FEATURE_COUNT values to fill in
+	// - return: nothing
+	static void getFeatures(const Gameboard& board, int linesCleared, double features[FEATURE_COUNT]);
+
+	// the weighted sum of a board's features (higher is better)
+	// - param 1: the Gameboard
+	// - param 2: the number of lines cleared getting there
+	// - param 3: the Weights
+	// - return: the score
+	static double evaluate(const Gameboard& board, int linesCleared, const Weights& weights);
+
+private:
+	// score the best follow up after locking a first-ply shape
+	// - param 1: the Gameboard before the lock
+	// - param 2: the first-ply shape at its lock position
+	// - param 3: the next TetShape
+	// - return: the best score over the next shape's placements
+	double evaluatePlacement(const Gameboard& board, const GridTetromino& placed, TetShape nextShape) const;
+};
+
+#endif /* TETRISBOT_H */
@@ -1,7 +1,8 @@
 #pragma once
 #include "TetrisGame.h"
-#include "Gameboard.h"
+#include <algorithm>
 #include <assert.h>
+#include <stdexcept>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -10,23 +11,20 @@
 
 // constructor
 //   initialize/assign private member vars names that match param names
-//   reset() the game
+//   seed the simulation
 //   load font from file: fonts/RedOctober.ttf
 //   setup scoreText
-// - params: already specified
+// - params: already specified, seed is passed on to the simulation's randomizer
 constexpr int TetrisGame::BLOCK_WIDTH{32};			  // pixel width of a tetris block, init to 32
 constexpr int TetrisGame::BLOCK_HEIGHT{32};			  // pixel height of a tetris block, init to 32
-constexpr double TetrisGame::MAX_SECONDS_PER_TICK{0.75}; // the slowest "tick" rate (in seconds), init to 0.75
-constexpr double TetrisGame::MIN_SECONDS_PER_TICK{0.20}; // the fastest "tick" rate (in seconds), init to 0.20
+const sf::Color TetrisGame::GHOST_TINT{ 255, 255, 255, 80 };	  // tint of the ghost piece
+const std::chrono::nanoseconds TetrisGame::DEFAULT_BOT_INPUT_INTERVAL{ std::chrono::milliseconds(50) };
 
-TetrisGame::TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, const Point& gameboardOffset, const Point& nextShapeOffset) 
-	: window{ window }, blockSprite{ blockSprite }, gameboardOffset{ gameboardOffset }, nextShapeOffset{ nextShapeOffset } 
+TetrisGame::TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, const Point& gameboardOffset, const Point& nextShapeOffset,
+	std::uint64_t seed)
+	: simulation{ seed, RandomizerMode::BAG }, lastLoopTime{ InputStage::Clock::now() }, seed{ seed },
+	blockSprite{ blockSprite }, window{ window }, gameboardOffset{ gameboardOffset }, nextShapeOffset{ nextShapeOffset }
 {
-	TetrisGame::reset();
-	
-	currentShape.setGridLoc(board.getSpawnLoc());
-	nextShapeOffset.toString();
-
 	if (!scoreFont.loadFromFile("fonts/RedOctober.ttf"))
 	{
 		assert(false && "Missing font: RedOctober.ttf");
@@ -35,322 +33,547 @@ TetrisGame::TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, const
 	scoreText.setCharacterSize(18);
 	scoreText.setFillColor(sf::Color::White);
 	scoreText.setPosition(425, 325);
+	updateScoreDisplay(simulation.getScore());
+
+	if (!boardLayer.create(Gameboard::MAX_X * BLOCK_WIDTH, Gameboard::MAX_Y * BLOCK_HEIGHT))
+	{
+		throw std::runtime_error("Unable to create the gameboard render texture");
+	}
+	boardLayerSprite.setTexture(boardLayer.getTexture());
+	boardLayerSprite.setPosition(static_cast<float>(gameboardOffset.getX()), static_cast<float>(gameboardOffset.getY()));
+
+	publishSnapshot();
+}
+
+// destructor - stop() the simulation thread, then stopRecording()
+TetrisGame::~TetrisGame()
+{
+	stop();
+	stopRecording();
+}
+
+// run the simulation on its own thread, calling processGameLoop() whenever
+// a step or key input is due, until stop()
+// - params: none
+// - return: nothing
+void TetrisGame::start()
+{
+	if (simulationRunning)
+	{
+		return;
+	}
+	lastLoopTime = InputStage::Clock::now();
+	simulationRunning = true;
+	simulationThread = std::thread(&TetrisGame::simulationLoop, this);
+}
+
+// stop & join the simulation thread (if it's running)
+// - params: none
+// - return: nothing
+void TetrisGame::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		simulationRunning = false;
+	}
+	wakeCondition.notify_one();
+	if (simulationThread.joinable())
+	{
+		simulationThread.join();
+	}
+}
+
+// restart the game (same seed) and record it to a replay file
+//   (pauses the simulation thread while it does, if it's running)
+// - param 1: the replay file path
+// - return: false if the file couldn't be created (the game isn't restarted)
+bool TetrisGame::startRecording(const std::string& path)
+{
+	const bool wasRunning = simulationRunning;
+	stop();
+	stopRecording();
+	bool opened = recorder.open(path, seed, RandomizerMode::BAG);
+	if (opened)
+	{
+		simulation.newGame(seed, RandomizerMode::BAG);
+		inputStage.clear();
+		autoShift.clear();
+		botPlanLength = 0;
+		botPlanNext = 0;
+		botPlanPiece = -1;
+		simulation.setRecorder(&recorder);
+		publishSnapshot();
+	}
+	if (wasRunning)
+	{
+		start();
+	}
+	return opened;
+}
+
+// finish the replay file (with the final score & board) if recording
+// - params: none
+// - return: nothing
+void TetrisGame::stopRecording()
+{
+	if (recorder.isOpen())
+	{
+		simulation.setRecorder(nullptr);
+		recorder.finish(simulation);
+	}
 }
 
 // Draw anything to do with the game,
-//   includes the board, currentShape, nextShape, score
-//   called every game loop
+//   includes the board, currentShape, its ghost (landing spot), nextShape, score
+//   called every frame (on the window thread)
+//   Everything is drawn from the newest GameSnapshot the simulation has published.
+//   The locked blocks come from the cached boardLayer (see updateBoardLayer()),
+//   the moving blocks are batched into blockVertices and drawn with one draw call.
 // - params: none
 // - return: nothing
 void TetrisGame::draw() {
-	
-	drawGameboard();
-	drawTetromino(currentShape, gameboardOffset);
-	drawGameboard();
+	drawCallCount = 0;
+
+	snapshots.update();
+	const GameSnapshot& snapshot = snapshots.getReadBuffer();
+	if (snapshot.score != displayedScore)
+	{
+		updateScoreDisplay(snapshot.score);
+	}
+
+	updateBoardLayer(snapshot);
+	window.draw(boardLayerSprite);
+	drawCallCount++;
+
+	blockVertices.clear();
+	addTetromino(snapshot.ghostShape, gameboardOffset, GHOST_TINT);
+	addTetromino(snapshot.currentShape, gameboardOffset);
+	addTetromino(snapshot.nextShape, nextShapeOffset);
+
+	sf::RenderStates states;
+	states.texture = blockSprite.getTexture();
+	window.draw(blockVertices, states);
+	drawCallCount++;
+
 	window.draw(scoreText);
+	drawCallCount++;
+}
+
+// the number of draw calls made by the last draw()
+// (including any made redrawing the boardLayer)
+// - params: none
+// - return: an int, the draw call count
+int TetrisGame::getDrawCallCount() const {
+	return drawCallCount;
 }
 
 // Event and game loop processing
 // handles keypress events (up, left, right, down, space)
+// by sending the matching GameInput (stamped with its arrival time)
+// to the simulation, B toggles the bot on/off
+// (called on the window thread)
 // - param 1: sf::Event event
+// - param 2: when the event was polled
 // - return: nothing
-void TetrisGame::onKeyPressed(const sf::Event& event) {
+void TetrisGame::onKeyPressed(const sf::Event& event, InputStage::Clock::time_point arrival) {
 	switch (event.key.code)
 	{
 	case sf::Keyboard::Up:
-		attemptRotate(currentShape);
+		sendKeyInput(KeyInput{ GameInput::ROTATE, false, arrival });
 		break;
 	case sf::Keyboard::Right:
-		attemptMove(currentShape, 1, 0);
+		if (!rightHeld && sendKeyInput(KeyInput{ GameInput::RIGHT, false, arrival }))
+		{
+			rightHeld = true;
+		}
 		break;
 	case sf::Keyboard::Left:
-		attemptMove(currentShape, -1, 0);
+		if (!leftHeld && sendKeyInput(KeyInput{ GameInput::LEFT, false, arrival }))
+		{
+			leftHeld = true;
+		}
 		break;
 	case sf::Keyboard::Down:
-		if (!attemptMove(currentShape, 0, 1)) {
-			lock(currentShape);
-		}
+		sendKeyInput(KeyInput{ GameInput::SOFT_DROP, false, arrival });
 		break;
 	case sf::Keyboard::Space:
-		drop(currentShape);
-		lock(currentShape);
+		sendKeyInput(KeyInput{ GameInput::HARD_DROP, false, arrival });
+		break;
+	case sf::Keyboard::B:
+		botPlaying = !botPlaying;
+		wakeSimulationThread();	// it may be asleep until the next gravity tick
 		break;
 	default:
 		break;
 	}
 }
 
-// called every game loop to handle ticks & tetromino placement (locking)
-// - param 1: float secondsSinceLastLoop
-// return: nothing
-void TetrisGame::processGameLoop(const float secondsSinceLastLoop) {
-	secondsSinceLastTick += secondsSinceLastLoop;
-	if (secondsSinceLastTick >= MAX_SECONDS_PER_TICK)
+// handles key release events, letting go of a held left or right
+// (called on the window thread)
+// - param 1: sf::Event event
+// - param 2: when the event was polled
+// - return: nothing
+void TetrisGame::onKeyReleased(const sf::Event& event, InputStage::Clock::time_point arrival) {
+	if (event.key.code == sf::Keyboard::Left && leftHeld)
 	{
-		tick();
-		secondsSinceLastTick -= secondsPerTick;
-		
+		leftHeld = !sendKeyInput(KeyInput{ GameInput::LEFT, true, arrival });
 	}
-	if (shapePlacedSinceLastGameLoop)
+	else if (event.key.code == sf::Keyboard::Right && rightHeld)
 	{
-		shapePlacedSinceLastGameLoop = false;
-		if (spawnNextShape())
-		{
-			switch (board.removeCompletedRows())
-			{
-			case 1:
-				score += SINGLE_LINE;
-				updateScoreDisplay();
-				break;
-			case 2:
-				score += DOUBLE_LINE;
-				updateScoreDisplay();
-				break;
-			case 3:
-				score += TRIPLE_LINE;
-				updateScoreDisplay();
-				break;
-			case 4:
-				score += TETRIS_LINE;
-				updateScoreDisplay();
-				break;
-			default:
-				break;
-			}
-			pickNextShape();
-		}
-		else {
-			reset();
-		}
+		rightHeld = !sendKeyInput(KeyInput{ GameInput::RIGHT, true, arrival });
 	}
-	
 }
 
+// the window lost focus, so it won't see the held keys go up: release them now
+// (called on the window thread)
+// - param 1: when the event was polled
+// - return: nothing
+void TetrisGame::onFocusLost(InputStage::Clock::time_point arrival) {
+	if (leftHeld)
+	{
+		leftHeld = !sendKeyInput(KeyInput{ GameInput::LEFT, true, arrival });
+	}
+	if (rightHeld)
+	{
+		rightHeld = !sendKeyInput(KeyInput{ GameInput::RIGHT, true, arrival });
+	}
+}
 
-// A tick() forces the currentShape to move (if there were no tick,
-// the currentShape would float in position forever). This should
-// call attemptMove() on the currentShape.  If not successful, lock() 
-// the currentShape (it can move no further).
+// take the newest GameSnapshot, if the simulation has published one since the last call
+// (called on the window thread)
 // - params: none
+// - return: true if there's a new snapshot to draw
+bool TetrisGame::updateSnapshot() {
+	return snapshots.update();
+}
+
+// sleep until the simulation publishes a snapshot, the window has input (see WakeSignal) or a timeout
+// (called on the window thread)
+// - param 1: the longest to sleep (nanoseconds::max() has no limit)
+// - return: nothing
+void TetrisGame::waitForUpdate(std::chrono::nanoseconds timeout) {
+	snapshotSignal.wait(timeout);
+}
+
+// set the left/right auto repeat (see AutoShift), while the simulation thread is stopped
+// - param 1: DAS, the hold before repeating
+// - param 2: ARR, the time between repeats (0 shifts to the wall)
+// - return: nothing
+void TetrisGame::setAutoShiftTiming(std::chrono::nanoseconds delay, std::chrono::nanoseconds repeat) {
+	autoShift.setTiming(delay, repeat);
+}
+
+// set how fast the bot presses its planned inputs, while the simulation thread is stopped
+// - param 1: the time between its inputs (0 sends one input per simulation step)
+// - return: nothing
+void TetrisGame::setBotInputInterval(std::chrono::nanoseconds interval) {
+	botInputInterval = interval;
+}
+
+// time each processGameLoop() on the simulation thread, while the thread is stopped
+// - param 1: the FrameProfiler (nullptr stops timing), which must outlive the simulation thread
+// - param 2: the section to time it in, from FrameProfiler::addSection()
 // - return: nothing
-	void TetrisGame::tick() {
-		
-		if (!TetrisGame::attemptMove(currentShape, 0, 1)) {
-			TetrisGame::lock(this->currentShape);
+void TetrisGame::setProfiler(FrameProfiler* profiler, int section) {
+	this->profiler = profiler;
+	profilerSection = section;
+}
+
+// called every game loop to handle ticks & tetromino placement (locking)
+//   (by the simulation thread once start()ed)
+//   takes the key inputs sent by onKeyPressed() into the input stage (and
+//   the left/right downs & ups into the AutoShift), then runs every
+//   simulation step the scheduler says is owed. Before each one the queued
+//   inputs and auto shifts due by the end of that step are applied,
+//   along with the bot's inputs (if it's playing, see sendBotInputs()).
+//   The inputs that arrived since the last step are applied after the steps,
+//   then a new GameSnapshot is published if anything changed.
+// - param 1: the current time
+// return: nothing
+void TetrisGame::processGameLoop(InputStage::Clock::time_point now) {
+	KeyInput keyInput;
+	while (keyInputs.pop(keyInput))
+	{
+		const bool horizontal = keyInput.input == GameInput::LEFT || keyInput.input == GameInput::RIGHT;
+		const int direction = keyInput.input == GameInput::LEFT ? -1 : 1;
+		if (keyInput.released)
+		{
+			autoShift.release(direction, keyInput.arrival);
+			continue;
+		}
+		if (!inputStage.push(keyInput.input, keyInput.arrival))
+		{
+			continue;	// dropped (and counted) by the full InputStage, so don't auto repeat it either
+		}
+		if (horizontal)
+		{
+			autoShift.press(direction, keyInput.arrival);
 		}
 	}
 
-	// reset everything for a new game (use existing functions) 
-	//  - set the score to 0 and call updateScoreDisplay()
-	//  - call determineSecondsPerTick() to determine the tick rate.
-	//  - clear the gameboard,
-	//  - pick & spawn next shape
-	//  - pick next shape again (for the "on-deck" shape)
-	// - params: none
-	// - return: nothing
-	void TetrisGame::reset()
+	const int steps = scheduler.advance(now - lastLoopTime);
+	lastLoopTime = now;
+
+	// the owed steps ended a step apart, the last one getPendingTime() ago
+	InputStage::Clock::time_point stepEnd = now - scheduler.getPendingTime() - (steps - 1) * scheduler.getStepLength();
+	int applied = 0;
+	for (int step = 0; step < steps; step++)
 	{
-		score = 0;
-		updateScoreDisplay();
-		determineSecondsPerTick();
-		board.empty();
-		pickNextShape();
-		spawnNextShape();
-		pickNextShape();
+		sendBotInputs(stepEnd);
+		applied += inputStage.applyUntil(simulation, stepEnd, now);
+		applied += autoShift.applyUntil(simulation, stepEnd);
+		simulation.processGameLoop(scheduler.getStepLength());
+		stepEnd += scheduler.getStepLength();
 	}
+	applied += inputStage.applyUntil(simulation, now, now);
+	applied += autoShift.applyUntil(simulation, now);
 
-	// assign nextShape.setShape a new random shape  
-	// - params: none
-	// - return: nothing
-	void TetrisGame::pickNextShape()
+	if (steps > 0 || applied > 0)
 	{
-		nextShape.setShape(Tetromino::getRandomShape());
+		publishSnapshot();
 	}
+}
 
-	// copy the nextShape into the currentShape (through assignment)
-	//   position the currentShape to its spawn location.
-	// - params: none
-	// - return: bool, true/false based on isPositionLegal()
-	bool TetrisGame::spawnNextShape() {
-		currentShape = nextShape;
-		currentShape.setGridLoc(board.getSpawnLoc());
-		return isPositionLegal(currentShape);
-	}
+// the number of key inputs dropped because the queue to the simulation thread was full
+//   (the InputStage counts the ones it drops itself, see getInputStage())
+// (called on the window thread)
+// - params: none
+// - return: the count
+unsigned long long TetrisGame::getDroppedKeyInputCount() const {
+	return droppedKeyInputCount;
+}
+
+// the input queue, for its key-to-board latency statistics
+//   (the simulation thread's, only read it while the thread is stopped)
+// - params: none
+// - return: the InputStage
+const InputStage& TetrisGame::getInputStage() const {
+	return inputStage;
+}
+
+// the step scheduler, for its step & dropped time counts
+//   (the simulation thread's, only read it while the thread is stopped)
+// - params: none
+// - return: the TickScheduler
+const TickScheduler& TetrisGame::getScheduler() const {
+	return scheduler;
+}
+
+// Simulation thread methods =====================================
 
-	// Test if a rotation is legal on the tetromino and if so, rotate it. 
-	//  To accomplish this:
-	//	 1) create a (local) temporary copy of the tetromino
-	//	 2) rotate it (temp.rotateClockwise())
-	//	 3) test if temp rotation was legal (isPositionLegal()), 
-	//      if so - rotate the original tetromino.
-	// - param 1: GridTetromino shape
-	// - return: bool, true/false to indicate successful movement
-	bool TetrisGame::attemptRotate(GridTetromino& shape) {
-		GridTetromino temp{ shape };
-		temp.rotateClockwise();
-		if (isPositionLegal(temp) && static_cast<int>(shape.getShape()) != 4)
+// the simulation thread: processGameLoop() until stop(),
+//   sleeping until getTimeUntilWake() has passed, a key input arrives, the bot is toggled or stop()
+// - params: none
+// - return: nothing
+void TetrisGame::simulationLoop() {
+	std::unique_lock<std::mutex> lock(wakeMutex);
+	while (simulationRunning)
+	{
+		lock.unlock();
+		const InputStage::Clock::time_point now = InputStage::Clock::now();
 		{
-			shape.rotateClockwise();
+			FrameProfiler::ScopedTimer timer(profiler, profilerSection);
+			processGameLoop(now);
 		}
-		return true;
+		const bool botWasPlaying = botPlaying;	// the B key changes how long it can sleep
+		const InputStage::Clock::time_point wakeTime = now + getTimeUntilWake();
+		lock.lock();
+		wakeCondition.wait_until(lock, wakeTime,
+			[this, botWasPlaying]() { return !simulationRunning || !keyInputs.isEmpty() || botPlaying != botWasPlaying; });
+	}
+}
+
+// how long the simulation thread can sleep before something can change
+// - params: none
+// - return: the time
+std::chrono::nanoseconds TetrisGame::getTimeUntilWake() const {
+	if (botPlaying || autoShift.getDirection() != 0 || simulation.isAwaitingSpawn())
+	{
+		return scheduler.getTimeUntilNextStep();
 	}
+	const std::chrono::nanoseconds untilTick = simulation.getTimeUntilTick();
+	const long long stepsUntilTick = (untilTick + scheduler.getStepLength() - std::chrono::nanoseconds(1)) / scheduler.getStepLength();
+	const int steps = static_cast<int>(std::max(1LL, std::min<long long>(stepsUntilTick, scheduler.getMaxSteps())));
+	return scheduler.getTimeUntilSteps(steps);
+}
 
-	// test if a move is legal on the tetromino, if so, move it.
-	//  To do this:
-	//	 1) create a (local) temporary copy of the tetromino
-	//	 2) move it (temp.move())
-	//	 3) test if temp move was legal (isPositionLegal(),
-	//      if so - move the original.	
-	// - param 1: GridTetromino shape
-	// - param 2: int x;
-	// - param 3: int y;
-	// - return: true/false to indicate successful movement
-	bool TetrisGame::attemptMove(GridTetromino& shape, int x, int y) {
-		
-		GridTetromino temp{ shape };
-		temp.move(x, y);
-		if (isPositionLegal(temp))
+// queue the bot's inputs due by a time into the InputStage, the same way key inputs are
+//   The bot plans each shape once, when it spawns, then presses the planned
+//   inputs one botInputInterval apart (at most one per step if that's 0),
+//   so it plays at a human-like pace against gravity. A plan left unfinished
+//   when its shape locks (eg: by gravity) is thrown away.
+//   Turning the bot off throws its plan away.
+// - param 1: send the inputs due at or before this time (the end of the step)
+// - return: nothing
+void TetrisGame::sendBotInputs(InputStage::Clock::time_point until) {
+	if (!botPlaying)
+	{
+		botPlanLength = 0;
+		botPlanNext = 0;
+		botPlanPiece = -1;
+		return;
+	}
+	if (simulation.isAwaitingSpawn())
+	{
+		return;
+	}
+	if (simulation.getPiecesLocked() != botPlanPiece || simulation.getGamesLost() != botPlanGame)
+	{
+		// a new shape: plan it, the first input can go at the start of this step
+		botPlanLength = bot.plan(simulation, botPlan, TetrisBot::MAX_PLAN_LENGTH);
+		botPlanNext = 0;
+		botPlanPiece = simulation.getPiecesLocked();
+		botPlanGame = simulation.getGamesLost();
+		nextBotInputTime = std::max(nextBotInputTime, until - scheduler.getStepLength());
+	}
+	const std::chrono::nanoseconds interval = std::max(botInputInterval, scheduler.getStepLength());
+	while (botPlanNext < botPlanLength && nextBotInputTime <= until)
+	{
+		if (!inputStage.push(botPlan[botPlanNext], nextBotInputTime))
 		{
-			shape.move(x, y);
-			return true;
+			break;	// the queue is full, try again next step
 		}
+		botPlanNext++;
+		nextBotInputTime += interval;
+	}
+}
+
+// send a key input to the simulation thread, and wake it
+// - param 1: the KeyInput
+// - return: false if the queue was full and the input was dropped
+bool TetrisGame::sendKeyInput(const KeyInput& keyInput) {
+	if (!keyInputs.push(keyInput))
+	{
+		droppedKeyInputCount++;
 		return false;
 	}
+	wakeSimulationThread();
+	return true;
+}
 
-	// drops the tetromino vertically as far as it can 
-	//   legally go.  Use attemptMove(). This can be done in 1 line.
-	// - param 1: GridTetromino shape
-	// - return: nothing;
-	void TetrisGame::drop(GridTetromino& shape) {
-		while (attemptMove(shape, 0, 1));
+// wake the simulation thread, so it rechecks the key inputs & getTimeUntilWake()
+// - params: none
+// - return: nothing
+void TetrisGame::wakeSimulationThread() {
+	{
+		// taking the lock means the simulation thread is either asleep, or yet to check the queue
+		std::lock_guard<std::mutex> lock(wakeMutex);
 	}
+	wakeCondition.notify_one();
+}
 
-	// copy the contents (color) of the tetromino's mapped block locs to the grid.
-		//	 1) get the tetromino's mapped locs via tetromino.getBlockLocsMappedToGrid()
-		//   2) use the board's setContent() method to set the content at the mapped locations.
-		//   3) record the fact that we placed a shape by setting shapePlacedSinceLastGameLoop
-		//      to true
-		// - param 1: GridTetromino shape
-		// - return: nothing
-	void TetrisGame::lock(const GridTetromino& shape) {
-		for (Point p : shape.getBlockLocsMappedToGrid())
-		{
-			board.setContent(p, static_cast<int>(shape.getColor()));
-		}
-		shapePlacedSinceLastGameLoop = true;
+// capture the simulation into a new GameSnapshot and publish it to the window thread
+//   (unless it would be the same as the last one)
+// - params: none
+// - return: nothing
+void TetrisGame::publishSnapshot() {
+	if (publishedSnapshot.isCurrent(simulation))
+	{
+		return;
 	}
+	GameSnapshot& snapshot = snapshots.getWriteBuffer();
+	snapshot.capture(simulation, publishedSnapshot.revision + 1);
+	publishedSnapshot = snapshot;
+	snapshots.publish();
+	snapshotSignal.notify();
+}
 
 	// Graphics methods ==============================================
 
-	// Draw a tetris block sprite on the canvas		
+	// Add a tetris block to a block batch
 	// The block position is specified in terms of 2 offsets: 
 	//    1) the top left (of the gameboard in pixels)
 	//    2) an x & y offset into the gameboard - in blocks (not pixels)
 	//       meaning they need to be multiplied by BLOCK_WIDTH and BLOCK_HEIGHT
 	//       to get the pixel offset.
-	//	 1) set the block color using blockSprite.setTextureRect()
-	//   2) set the block location using blockSprite.setPosition()   
-	//	 3) draw the block using window.draw()
-	//   For details/instructions on these 3 operations see:
-	//       www.sfml-dev.org/tutorials/2.5/graphics-sprite.php
-	//       use member variables: window and blockSprite (assigned in constructor)
-	// param 1: Point topLeft
-	// param 2: int xOffset
-	// param 3: int yOffset
-	// param 4: TetColor color
+	//   Appends one quad (4 vertices) whose texture coords pick the block's
+	//   color out of tiles.png, the same rect the blockSprite would use.
+	// param 1: sf::VertexArray the batch to add to
+	// param 2: Point topLeft
+	// param 3: int xOffset
+	// param 4: int yOffset
+	// param 5: TetColor color
+	// param 6: sf::Color tint, multiplied with the texture (translucent for the ghost piece)
 	// return: nothing
-	void TetrisGame::drawBlock(const Point& topLeft, int xOffset, int yOffset, TetColor color) const {
-		//std::cout << "this is the x position" << static_cast<int>(topLeft.getX() + xOffset * BLOCK_WIDTH) << std::endl;
-		//std::cout << topLeft.getX() + xOffset * BLOCK_WIDTH << " " << topLeft.getY() + yOffset * BLOCK_HEIGHT << std::endl;
-		blockSprite.setPosition(topLeft.getX() + xOffset * BLOCK_WIDTH, topLeft.getY() + yOffset * BLOCK_HEIGHT);
-		blockSprite.setTextureRect(sf::IntRect(static_cast<int>(color) * BLOCK_WIDTH, 0, BLOCK_WIDTH, BLOCK_HEIGHT));
-		window.draw(blockSprite);
+	void TetrisGame::addBlock(sf::VertexArray& vertices, const Point& topLeft, int xOffset, int yOffset, TetColor color,
+		const sf::Color& tint) const {
+		const float left = static_cast<float>(topLeft.getX() + xOffset * BLOCK_WIDTH);
+		const float top = static_cast<float>(topLeft.getY() + yOffset * BLOCK_HEIGHT);
+		const float textureLeft = static_cast<float>(static_cast<int>(color) * BLOCK_WIDTH);
+
+		vertices.append(sf::Vertex({ left, top }, tint, { textureLeft, 0.f }));
+		vertices.append(sf::Vertex({ left + BLOCK_WIDTH, top }, tint, { textureLeft + BLOCK_WIDTH, 0.f }));
+		vertices.append(sf::Vertex({ left + BLOCK_WIDTH, top + BLOCK_HEIGHT }, tint, { textureLeft + BLOCK_WIDTH, static_cast<float>(BLOCK_HEIGHT) }));
+		vertices.append(sf::Vertex({ left, top + BLOCK_HEIGHT }, tint, { textureLeft, static_cast<float>(BLOCK_HEIGHT) }));
 	}
 
-	// Draw the gameboard blocks on the window
-	//   Iterate through each row & col, use drawBlock() to 
-	//   draw a block if it isn't empty.
-	// params: none
+	// Add the gameboard blocks to a block batch
+	//   Iterate through each row & col, use addBlock() to 
+	//   add a block if it isn't empty.
+	// param 1: sf::VertexArray the batch to add to
+	// param 2: Point topLeft
+	// param 3: GameSnapshot the board to add
 	// return: nothing
-	void TetrisGame::drawGameboard() {
-		for (int y = 0;y < Gameboard::MAX_Y; y++)
+	void TetrisGame::addGameboard(sf::VertexArray& vertices, const Point& topLeft, const GameSnapshot& snapshot) const {
+		for (int y = 0; y < Gameboard::MAX_Y; y++)
 		{
 			for (int x = 0; x < Gameboard::MAX_X; x++)
 			{
-				if (board.getContent(x, y) != Gameboard::EMPTY_BLOCK) {
-					drawBlock(gameboardOffset, x, y, static_cast<TetColor>(board.getContent(x, y)));
+				const int content = snapshot.cells[y][x];
+				if (content != Gameboard::EMPTY_BLOCK) {
+					addBlock(vertices, topLeft, x, y, static_cast<TetColor>(content));
 				}
 			}
 		}
 	}
 
-	// Draw a tetromino on the window
-	//	 Iterate through each mapped loc & drawBlock() for each.
+	// Redraw the boardLayer if the snapshot's board has changed since it was last drawn.
+	//   Between locks this does nothing, so steady state frames never touch the locked blocks.
+	// param 1: GameSnapshot the snapshot being drawn
+	// return: nothing
+	void TetrisGame::updateBoardLayer(const GameSnapshot& snapshot) {
+		if (boardLayerValid && boardLayerRevision == snapshot.boardRevision) {
+			return;
+		}
+		boardVertices.clear();
+		addGameboard(boardVertices, Point{ 0, 0 }, snapshot);
+
+		sf::RenderStates states;
+		states.texture = blockSprite.getTexture();
+		boardLayer.clear(sf::Color::Transparent);
+		boardLayer.draw(boardVertices, states);
+		boardLayer.display();
+		drawCallCount++;
+
+		boardLayerRevision = snapshot.boardRevision;
+		boardLayerValid = true;
+	}
+
+	// Add a tetromino to the block batch (blockVertices)
+	//	 Iterate through each mapped loc & addBlock() for each.
 	//   The topLeft determines a 'base point' from which to calculate block offsets
 	//      If the Tetromino is on the gameboard: use gameboardOffset
 	// param 1: GridTetromino tetromino
 	// param 2: Point topLeft
+	// param 3: sf::Color tint, see addBlock()
 	// return: nothing
-	void TetrisGame::drawTetromino(const GridTetromino& tetromino, const Point& topLeft) {
-
+	void TetrisGame::addTetromino(const GridTetromino& tetromino, const Point& topLeft, const sf::Color& tint) {
 		for (const Point& point : tetromino.getBlockLocsMappedToGrid()) {
-		
-			 drawBlock(topLeft, point.getX(), point.getY(), tetromino.getColor());
+			addBlock(blockVertices, topLeft, point.getX(), point.getY(), tetromino.getColor(), tint);
 		}
 	}
 
 	// update the score display
 	// form a string "score: ##" to display the current score
 	// user scoreText.setString() to display it.
-	// params: none:
+	// param 1: int the score
 	// return: nothing
-	void TetrisGame::updateScoreDisplay() {
+	void TetrisGame::updateScoreDisplay(int score) {
 		std::stringstream msg;
 		std::string message;
-		msg << "Score: " << score;
+		displayedScore = score;
+		msg << "Score: " << displayedScore;
 		message = msg.str();
 
 		scoreText.setString(message);
 	}
-
-	// State & gameplay/logic methods ================================
-
-	// Determine if a Tetromino can legally be placed at its current position
-	// on the gameboard.
-	//   Tip: Make use of Gameboard's areLocsEmpty() and pass it the shape's mapped locs.
-	// - param 1: GridTetromino shape
-	// - return: bool, true if shape is within borders (isShapeWithinBorders()) and 
-	//           the shape's mapped board locs are empty (false otherwise).
-	bool  TetrisGame::isPositionLegal(const GridTetromino& shape) const {
-
-		return board.areAllLocsEmpty(shape.getBlockLocsMappedToGrid()) && isWithinBorders(shape);
-	}
-
-
-	// Determine if the shape is within the left, right, & bottom gameboard borders
-	//   * Ignore the upper border because we want shapes to be able to drop
-	//     in from the top of the gameboard.
-	//   All of a shape's blocks must be inside these 3 borders to return true
-	// - param 1: GridTetromino shape
-	// - return: bool, true if the shape is within the left, right, and lower border
-	//	         of the grid, but *NOT* the top border (false otherwise)
-	bool TetrisGame::isWithinBorders(const GridTetromino& shape) const {
-		for (Point p : shape.getBlockLocsMappedToGrid())
-		{
-			if (p.getX() < 0 || p.getX() >= Gameboard::MAX_X ||  p.getY() >= Gameboard::MAX_Y)
-			{
-				return false;
-			}
-		}
-		return true;
-	}
-
-
-	// set secsPerTick 
-	//   - basic: use MAX_SECS_PER_TICK
-	//   - advanced: base it on score (higher score results in lower secsPerTick)
-	// params: none
-	// return: nothing
-	void TetrisGame::determineSecondsPerTick() {
-		secondsPerTick = MAX_SECONDS_PER_TICK;
-	}
\ No newline at end of file
@@ -1,4 +1,6 @@
-// This class encapsulates the tetris game and its drawing routines, gameplay, & control logic.
+// This class draws a tetris game and feeds it keyboard input.
+// The game rules themselves live in TetrisSimulation (no SFML dependency),
+// this class is the renderer and input adapter wrapped around one.
 // This class was designed so with the idea of potentially instantiating 2 of them
 // and have them run side by side (player vs player).
 // So, anything you would need for an individual tetris game has been included here.
@@ -6,19 +8,36 @@
 // rendering a tetromino block) was left in main.cpp
 // 
 // This class is responsible for:
-//   - setting up the board,
 //	 - drawing game elements to the screen
-//   - spawning tetrominoes,
-//   - handling user input,
-//   - moving and placing tetrominoes 
+//   - translating user input into GameInputs for the simulation
+//   - running the simulation on its own thread (see start())
 //
-//  [expected .cpp size: ~ 275 lines]
+// Once start()ed the simulation, its scheduler, input stage, bot and recorder
+// belong to the simulation thread. The window thread only talks to it through
+// two lock-free handoffs: key inputs go over an SpscQueue, and GameSnapshots
+// of the board, shapes & score come back through a TripleBuffer, so a slow
+// window.display() can never stall the game (or a slow step the drawing).
 
 #ifndef TETRISGAME_H
 #define TETRISGAME_H
 
-#include "Gameboard.h"
-#include "GridTetromino.h"
+#include "AutoShift.h"
+#include "FrameProfiler.h"
+#include "GameSnapshot.h"
+#include "InputStage.h"
+#include "ReplayRecorder.h"
+#include "SpscQueue.h"
+#include "TaskPool.h"
+#include "TetrisBot.h"
+#include "TetrisSimulation.h"
+#include "TickScheduler.h"
+#include "TripleBuffer.h"
+#include "WakeSignal.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <SFML/Graphics.hpp>
 
 
@@ -28,206 +47,311 @@ public:
 	// STATIC CONSTANTS
 	static const int BLOCK_WIDTH;			  // pixel width of a tetris block, init to 32
 	static const int BLOCK_HEIGHT;			  // pixel height of a tetris block, int to 32
-	static const double MAX_SECONDS_PER_TICK; // the slowest "tick" rate (in seconds), init to 0.75
-	static const double MIN_SECONDS_PER_TICK; // the fastest "tick" rate (in seconds), init to 0.20
-	const int SINGLE_LINE{ 40 };
-	const int DOUBLE_LINE{ 100 };
-	const int TRIPLE_LINE{ 300 };
-	const int TETRIS_LINE{ 1200 };
+	static const sf::Color GHOST_TINT;		  // tint of the ghost piece (where the current shape will land)
+	static const unsigned int INPUT_QUEUE_CAPACITY = 64;	// key inputs in flight to the simulation thread
+	static const std::chrono::nanoseconds DEFAULT_BOT_INPUT_INTERVAL;	// the time between the bot's inputs, init to 50 ms
 
 private:	
 	// MEMBER VARIABLES
 
-	// State members ---------------------------------------------
-	int score;					// the current game score.
-    Gameboard board;			// the gameboard (grid) to represent where all the blocks are.
-    GridTetromino nextShape;	// the tetromino shape that is "on deck".
-    GridTetromino currentShape;	// the tetromino that is currently falling.
-	
+	// State members (the simulation thread's) -------------------
+	TetrisSimulation simulation;	// the game rules & state (board, shapes, score, timing)
+	TickScheduler scheduler;		// splits wall time into fixed simulation steps
+	InputStage inputStage;			// key inputs waiting for the simulation to reach their time
+	AutoShift autoShift;			// repeats held left/right keys (DAS/ARR)
+	InputStage::Clock::time_point lastLoopTime;	// when processGameLoop() last ran
+	const std::uint64_t seed;		// the simulation's randomizer seed
+	ReplayRecorder recorder;		// records the game when startRecording() is called
+	FrameProfiler* profiler{ nullptr };	// times processGameLoop(), if set
+	int profilerSection{ -1 };		// the profiler section it's timed in
+
+	// Bot members -----------------------------------------------
+	TaskPool botPool;				// the bot's worker threads
+	TetrisBot bot{ &botPool };		// the built-in AI player
+	std::atomic<bool> botPlaying{ false };	// toggled with the B key (on the window thread)
+	GameInput botPlan[TetrisBot::MAX_PLAN_LENGTH];	// the inputs placing the current shape
+	int botPlanLength{ 0 };
+	int botPlanNext{ 0 };			// the next planned input to send
+	int botPlanPiece{ -1 };			// the getPiecesLocked() & getGamesLost() the plan was made at,
+	int botPlanGame{ -1 };			// so a new shape spawning can be told apart (-1: no plan)
+	std::chrono::nanoseconds botInputInterval{ DEFAULT_BOT_INPUT_INTERVAL };
+	InputStage::Clock::time_point nextBotInputTime;	// when the bot's next input is due
+
+	// Thread members --------------------------------------------
+	struct KeyInput
+	{
+		GameInput input;
+		bool released;				// a left/right key going up (for the AutoShift)
+		InputStage::Clock::time_point arrival;
+	};
+	bool leftHeld{ false };			// the left/right key states (on the window thread),
+	bool rightHeld{ false };		// so the OS key repeats can be told apart from presses
+	SpscQueue<KeyInput, INPUT_QUEUE_CAPACITY> keyInputs;	// window thread -> simulation thread
+	unsigned long long droppedKeyInputCount{ 0 };	// key inputs that found keyInputs full (on the window thread)
+	TripleBuffer<GameSnapshot> snapshots;	// simulation thread -> window thread
+	WakeSignal snapshotSignal;		// notified with each snapshot published, for waitForUpdate()
+	GameSnapshot publishedSnapshot;	// a copy of the last one published (on the simulation thread)
+	std::thread simulationThread;
+	std::atomic<bool> simulationRunning{ false };
+	std::mutex wakeMutex;			// the simulation thread sleeps on wakeCondition
+	std::condition_variable wakeCondition;	// until its next step is due, a key input arrives, the bot is toggled or stop()
+
 	// Graphics members ------------------------------------------
 	sf::Sprite& blockSprite;		// the sprite used for all the blocks.
 	sf::RenderWindow& window;		// the window that we are drawing on.
 	const Point gameboardOffset;	// pixel XY offset of the gameboard on the screen
 	const Point nextShapeOffset;	// pixel XY offset to the nextShape
 
+	sf::VertexArray blockVertices{ sf::Quads };	// the moving blocks drawn this frame, sharing the tiles texture
+	int drawCallCount{ 0 };			// draw() calls made by the last draw()
+
+	sf::RenderTexture boardLayer;	// the locked gameboard blocks, rendered off screen
+	sf::Sprite boardLayerSprite;	// draws boardLayer at the gameboardOffset
+	sf::VertexArray boardVertices{ sf::Quads };	// scratch batch used to redraw boardLayer
+	unsigned int boardLayerRevision{ 0 };	// the simulation board revision boardLayer shows
+	bool boardLayerValid{ false };	// false until boardLayer has been drawn once
+
 	sf::Font scoreFont;				// SFML font for displaying the score.
 	sf::Text scoreText;				// SFML text object for displaying the score
+	int displayedScore{ -1 };		// the score currently shown in scoreText
 									
-	// Time members ----------------------------------------------
-	// Note: a "tick" is the amount of time it takes a block to fall one line.
-	double secondsPerTick = MAX_SECONDS_PER_TICK; // the seconds per tick (changes depending on score)	
-
-	double secondsSinceLastTick{ 0.0 };			// update this every game loop until it is >= secsPerTick,
-												// we then know to trigger a tick.  Reduce this var (by a tick) & repeat.
-	bool shapePlacedSinceLastGameLoop{ false };	// Tracks whether we have placed (locked) a shape on
-												// the gameboard in the current gameloop	
 public:
 	// MEMBER FUNCTIONS
 
 	// constructor
 	//   initialize/assign private member vars names that match param names
-	//   reset() the game
+	//   seed the simulation
 	//   load font from file: fonts/RedOctober.ttf
 	//   setup scoreText
-	// - params: already specified
-	TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, const Point& gameboardOffset, const Point& nextShapeOffset);
+	// - params: already specified, seed is passed on to the simulation's randomizer
+	TetrisGame(sf::RenderWindow& window, sf::Sprite& blockSprite, const Point& gameboardOffset, const Point& nextShapeOffset,
+		std::uint64_t seed);
+
+	// destructor - stop() the simulation thread, then stopRecording()
+	~TetrisGame();
+
+	// run the simulation on its own thread, calling processGameLoop() whenever
+	// a step or key input is due, until stop()
+	// - params: none
+	// - return: nothing
+	void start();
+
+	// stop & join the simulation thread (if it's running)
+	// - params: none
+	// - return: nothing
+	void stop();
+
+	// restart the game (same seed) and record it to a replay file
+	//   (pauses the simulation thread while it does, if it's running)
+	// - param 1: the replay file path
+	// - return: false if the file couldn't be created (the game isn't restarted)
+	bool startRecording(const std::string& path);
+
+	// finish the replay file (with the final score & board) if recording
+	// - params: none
+	// - return: nothing
+	void stopRecording();
 
 	// Draw anything to do with the game,
-	//   includes the board, currentShape, nextShape, score
-	//   called every game loop
+	//   includes the board, currentShape, its ghost (landing spot), nextShape, score
+	//   called every frame (on the window thread)
+	//   Everything is drawn from the newest GameSnapshot the simulation has published.
+	//   The locked blocks come from the cached boardLayer (see updateBoardLayer()),
+	//   the moving blocks are batched into blockVertices and drawn with one draw call.
 	// - params: none
 	// - return: nothing
 	void draw();
 
+	// the number of draw calls made by the last draw()
+	// (including any made redrawing the boardLayer)
+	// - params: none
+	// - return: an int, the draw call count
+	int getDrawCallCount() const;
+
+	// set the left/right auto repeat (see AutoShift), while the simulation thread is stopped
+	// - param 1: DAS, the hold before repeating
+	// - param 2: ARR, the time between repeats (0 shifts to the wall)
+	// - return: nothing
+	void setAutoShiftTiming(std::chrono::nanoseconds delay, std::chrono::nanoseconds repeat);
+
+	// set how fast the bot presses its planned inputs, while the simulation thread is stopped
+	// - param 1: the time between its inputs (0 sends one input per simulation step)
+	// - return: nothing
+	void setBotInputInterval(std::chrono::nanoseconds interval);
+
+	// time each processGameLoop() on the simulation thread, while the thread is stopped
+	// - param 1: the FrameProfiler (nullptr stops timing), which must outlive the simulation thread
+	// - param 2: the section to time it in, from FrameProfiler::addSection()
+	// - return: nothing
+	void setProfiler(FrameProfiler* profiler, int section);
+
 	// Event and game loop processing
 	// handles keypress events (up, left, right, down, space)
+	// by sending the matching GameInput (stamped with its arrival time)
+	// to the simulation, B toggles the bot on/off
+	// Left & right are repeated by the AutoShift while held, so the OS's own
+	// key repeats of them are ignored.
+	// (called on the window thread)
 	// - param 1: sf::Event event
+	// - param 2: when the event was polled
+	// - return: nothing
+	void onKeyPressed(const sf::Event& event, InputStage::Clock::time_point arrival);
+
+	// handles key release events, letting go of a held left or right
+	// (called on the window thread)
+	// - param 1: sf::Event event
+	// - param 2: when the event was polled
+	// - return: nothing
+	void onKeyReleased(const sf::Event& event, InputStage::Clock::time_point arrival);
+
+	// the window lost focus, so it won't see the held keys go up: release them now
+	// (called on the window thread)
+	// - param 1: when the event was polled
+	// - return: nothing
+	void onFocusLost(InputStage::Clock::time_point arrival);
+
+	// take the newest GameSnapshot, if the simulation has published one since the last call
+	//   the window only needs redrawing when this (or the window itself) changes
+	// (called on the window thread)
+	// - params: none
+	// - return: true if there's a new snapshot to draw
+	bool updateSnapshot();
+
+	// sleep until the simulation publishes a snapshot, the window has input (see WakeSignal) or a timeout
+	//   The simulation thread only publishes when something changed (a key input,
+	//   the bot, a gravity tick), so the window thread needn't wake for anything else.
+	// (called on the window thread)
+	// - param 1: the longest to sleep (nanoseconds::max() has no limit)
 	// - return: nothing
-	void onKeyPressed(const sf::Event& event);
+	void waitForUpdate(std::chrono::nanoseconds timeout);
 
 	// called every game loop to handle ticks & tetromino placement (locking)
-	// - param 1: float secondsSinceLastLoop
+	//   (by the simulation thread once start()ed)
+	//   takes the key inputs sent by onKeyPressed() into the input stage (and
+	//   the left/right downs & ups into the AutoShift), then runs every
+	//   simulation step the scheduler says is owed. Before each one the queued
+	//   inputs and auto shifts due by the end of that step are applied,
+	//   along with the bot's inputs (if it's playing, see sendBotInputs()).
+	//   The inputs that arrived since the last step are applied after the steps,
+	//   then a new GameSnapshot is published if anything changed.
+	// - param 1: the current time
 	// return: nothing
-	void processGameLoop(const float secondsSinceLastLoop);
+	void processGameLoop(InputStage::Clock::time_point now);
 
-	// A tick() forces the currentShape to move (if there were no tick,
-	// the currentShape would float in position forever). This should
-	// call attemptMove() on the currentShape.  If not successful, lock() 
-	// the currentShape (it can move no further).
+	// the number of key inputs dropped because the queue to the simulation thread was full
+	//   (the InputStage counts the ones it drops itself, see getInputStage())
+	// (called on the window thread)
 	// - params: none
-	// - return: nothing
-	void tick();
+	// - return: the count
+	unsigned long long getDroppedKeyInputCount() const;
+
+	// the input queue, for its key-to-board latency statistics
+	//   (the simulation thread's, only read it while the thread is stopped)
+	// - params: none
+	// - return: the InputStage
+	const InputStage& getInputStage() const;
+
+	// the step scheduler, for its step & dropped time counts
+	//   (the simulation thread's, only read it while the thread is stopped)
+	// - params: none
+	// - return: the TickScheduler
+	const TickScheduler& getScheduler() const;
 
 private:
-	// reset everything for a new game (use existing functions) 
-	//  - set the score to 0 and call updateScoreDisplay()
-	//  - call determineSecondsPerTick() to determine the tick rate.
-	//  - clear the gameboard,
-	//  - pick & spawn next shape
-	//  - pick next shape again (for the "on-deck" shape)
+	// Simulation thread methods =====================================
+
+	// the simulation thread: processGameLoop() until stop(),
+	//   sleeping until getTimeUntilWake() has passed, a key input arrives, the bot is toggled or stop()
 	// - params: none
 	// - return: nothing
-	void reset();
+	void simulationLoop();
 
-	// assign nextShape.setShape a new random shape  
+	// how long the simulation thread can sleep before something can change:
+	//   the next step while anything is happening (a key held, the bot playing,
+	//   a shape waiting to spawn), otherwise the step with the next gravity tick
+	//   (at most the scheduler's maxSteps away, so no time is dropped)
 	// - params: none
+	// - return: the time
+	std::chrono::nanoseconds getTimeUntilWake() const;
+
+	// queue the bot's inputs due by a time into the InputStage, the same way key inputs are
+	//   The bot plans each shape once, when it spawns, then presses the planned
+	//   inputs one botInputInterval apart (at most one per step if that's 0),
+	//   so it plays at a human-like pace against gravity. A plan left unfinished
+	//   when its shape locks (eg: by gravity) is thrown away.
+	//   Turning the bot off throws its plan away.
+	// - param 1: send the inputs due at or before this time (the end of the step)
 	// - return: nothing
-	void pickNextShape();
-	
-	// copy the nextShape into the currentShape (through assignment)
-	//   position the currentShape to its spawn location.
+	void sendBotInputs(InputStage::Clock::time_point until);
+
+	// send a key input to the simulation thread, and wake it
+	// - param 1: the KeyInput
+	// - return: false if the queue was full and the input was dropped
+	bool sendKeyInput(const KeyInput& keyInput);
+
+	// wake the simulation thread, so it rechecks the key inputs & getTimeUntilWake()
 	// - params: none
-	// - return: bool, true/false based on isPositionLegal()
-	bool spawnNextShape();																	
-
-	// Test if a rotation is legal on the tetromino and if so, rotate it. 
-	//  To accomplish this:
-	//	 1) create a (local) temporary copy of the tetromino
-	//	 2) rotate it (temp.rotateClockwise())
-	//	 3) test if temp rotation was legal (isPositionLegal()), 
-	//      if so - rotate the original tetromino.
-	// - param 1: GridTetromino shape
-	// - return: bool, true/false to indicate successful movement
-	bool attemptRotate(GridTetromino& shape);
-   
-	// test if a move is legal on the tetromino, if so, move it.
-	//  To do this:
-	//	 1) create a (local) temporary copy of the tetromino
-	//	 2) move it (temp.move())
-	//	 3) test if temp move was legal (isPositionLegal(),
-	//      if so - move the original.	
-	// - param 1: GridTetromino shape
-	// - param 2: int x;
-	// - param 3: int y;
-	// - return: true/false to indicate successful movement
-	bool attemptMove(GridTetromino& shape, int x, int y);
-
-	// drops the tetromino vertically as far as it can 
-	//   legally go.  Use attemptMove(). This can be done in 1 line.
-	// - param 1: GridTetromino shape
-	// - return: nothing;
-	void drop(GridTetromino& shape);
-
-	// copy the contents (color) of the tetromino's mapped block locs to the grid.
-		//	 1) get the tetromino's mapped locs via tetromino.getBlockLocsMappedToGrid()
-		//   2) use the board's setContent() method to set the content at the mapped locations.
-		//   3) record the fact that we placed a shape by setting shapePlacedSinceLastGameLoop
-		//      to true
-		// - param 1: GridTetromino shape
-		// - return: nothing
-	void lock(const GridTetromino& shape);
-	
+	// - return: nothing
+	void wakeSimulationThread();
+
+	// capture the simulation into a new GameSnapshot and publish it to the window thread
+	//   (unless it would be the same as the last one)
+	// - params: none
+	// - return: nothing
+	void publishSnapshot();
+
 	// Graphics methods ==============================================
 	
-	// Draw a tetris block sprite on the canvas		
+	// Add a tetris block to a block batch
 	// The block position is specified in terms of 2 offsets: 
 	//    1) the top left (of the gameboard in pixels)
 	//    2) an x & y offset into the gameboard - in blocks (not pixels)
 	//       meaning they need to be multiplied by BLOCK_WIDTH and BLOCK_HEIGHT
 	//       to get the pixel offset.
-	//	 1) set the block color using blockSprite.setTextureRect()
-	//   2) set the block location using blockSprite.setPosition()   
-	//	 3) draw the block using window.draw()
-	//   For details/instructions on these 3 operations see:
-	//       www.sfml-dev.org/tutorials/2.5/graphics-sprite.php
-	//       use member variables: window and blockSprite (assigned in constructor)
-	// param 1: Point topLeft
-	// param 2: int xOffset
-	// param 3: int yOffset
-	// param 4: TetColor color
+	//   Appends one quad (4 vertices) whose texture coords pick the block's
+	//   color out of tiles.png, the same rect the blockSprite would use.
+	// param 1: sf::VertexArray the batch to add to
+	// param 2: Point topLeft
+	// param 3: int xOffset
+	// param 4: int yOffset
+	// param 5: TetColor color
+	// param 6: sf::Color tint, multiplied with the texture (translucent for the ghost piece)
 	// return: nothing
-	void drawBlock(const Point& topLeft, int xOffset, int yOffset, TetColor color) const;
+	void addBlock(sf::VertexArray& vertices, const Point& topLeft, int xOffset, int yOffset, TetColor color,
+		const sf::Color& tint = sf::Color::White) const;
 										
-	// Draw the gameboard blocks on the window
-	//   Iterate through each row & col, use drawBlock() to 
-	//   draw a block if it isn't empty.
-	// params: none
+	// Add the gameboard blocks to a block batch
+	//   Iterate through each row & col, use addBlock() to 
+	//   add a block if it isn't empty.
+	// param 1: sf::VertexArray the batch to add to
+	// param 2: Point topLeft
+	// param 3: GameSnapshot the board to add
+	// return: nothing
+	void addGameboard(sf::VertexArray& vertices, const Point& topLeft, const GameSnapshot& snapshot) const;
+
+	// Redraw the boardLayer if the snapshot's board has changed since it was last drawn.
+	//   Between locks this does nothing, so steady state frames never touch the locked blocks.
+	// param 1: GameSnapshot the snapshot being drawn
 	// return: nothing
-	void drawGameboard();
+	void updateBoardLayer(const GameSnapshot& snapshot);
 	
-	// Draw a tetromino on the window
-	//	 Iterate through each mapped loc & drawBlock() for each.
+	// Add a tetromino to the block batch (blockVertices)
+	//	 Iterate through each mapped loc & addBlock() for each.
 	//   The topLeft determines a 'base point' from which to calculate block offsets
 	//      If the Tetromino is on the gameboard: use gameboardOffset
 	// param 1: GridTetromino tetromino
 	// param 2: Point topLeft
+	// param 3: sf::Color tint, see addBlock()
 	// return: nothing
-	void drawTetromino(const GridTetromino& tetromino,const Point& topLeft);
+	void addTetromino(const GridTetromino& tetromino, const Point& topLeft, const sf::Color& tint = sf::Color::White);
 	
 	// update the score display
 	// form a string "score: ##" to display the current score
 	// user scoreText.setString() to display it.
-	// params: none:
+	// param 1: int the score
 	// return: nothing
-	void updateScoreDisplay();
-
-	// State & gameplay/logic methods ================================
+	void updateScoreDisplay(int score);
 
-	// Determine if a Tetromino can legally be placed at its current position
-	// on the gameboard.
-	//   Tip: Make use of Gameboard's areLocsEmpty() and pass it the shape's mapped locs.
-	// - param 1: GridTetromino shape
-	// - return: bool, true if shape is within borders (isShapeWithinBorders()) and 
-	//           the shape's mapped board locs are empty (false otherwise).
-	bool isPositionLegal(const GridTetromino& shape) const;
-
-	
-	// Determine if the shape is within the left, right, & bottom gameboard borders
-	//   * Ignore the upper border because we want shapes to be able to drop
-	//     in from the top of the gameboard.
-	//   All of a shape's blocks must be inside these 3 borders to return true
-	// - param 1: GridTetromino shape
-	// - return: bool, true if the shape is within the left, right, and lower border
-	//	         of the grid, but *NOT* the top border (false otherwise)
-	bool isWithinBorders(const GridTetromino& shape) const;
-
-
-	// set secsPerTick 
-	//   - basic: use MAX_SECS_PER_TICK
-	//   - advanced: base it on score (higher score results in lower secsPerTick)
-	// params: none
-	// return: nothing
-	void determineSecondsPerTick();
 	friend class TestSuite;
 
 };
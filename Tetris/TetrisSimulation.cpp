@@ -0,0 +1,618 @@
+#include "TetrisSimulation.h"
+#include "ReplayRecorder.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr double TetrisSimulation::MAX_SECONDS_PER_TICK{ 0.75 }; // the slowest "tick" rate (in seconds), init to 0.75
+constexpr double TetrisSimulation::MIN_SECONDS_PER_TICK{ 0.20 }; // the fastest "tick" rate (in seconds), init to 0.20
+
+// constructor
+//   seed the randomizer, reset() the game
+// - param 1: the randomizer seed (the same seed & inputs replay the same game)
+// - param 2: the RandomizerMode
+TetrisSimulation::TetrisSimulation(std::uint64_t seed, RandomizerMode mode)
+	: randomizer{ seed, mode }
+{
+	reset();
+}
+
+// reseed the randomizer and reset() the game
+// - param 1: the randomizer seed
+// - param 2: the RandomizerMode
+// - return: nothing
+void TetrisSimulation::newGame(std::uint64_t seed, RandomizerMode mode)
+{
+	randomizer.reseed(seed, mode);
+	gamesLost = 0;
+	loopCount = 0;
+	reset();
+}
+
+// reset everything for a new game (use existing functions) 
+//  - set the score (and lines & pieces) to 0
+//  - call determineSecondsPerTick() to determine the tick rate.
+//  - clear the gameboard,
+//  - pick & spawn next shape
+//  - pick next shape again (for the "on-deck" shape)
+// - params: none
+// - return: nothing
+void TetrisSimulation::reset()
+{
+	score = 0;
+	linesCleared = 0;
+	piecesLocked = 0;
+	determineSecondsPerTick();
+	timeSinceLastTick = std::chrono::nanoseconds::zero();
+	shapePlacedSinceLastGameLoop = false;
+	lockedRowsTop = 0;
+	lockedRowsBottom = -1;
+	board.empty();
+	boardRevision++;
+	pickNextShape();
+	spawnNextShape();
+	pickNextShape();
+}
+
+// apply a player input to the currentShape
+//   (ignored while awaiting spawn, the currentShape is already locked)
+// - param 1: GameInput input
+// - return: nothing
+void TetrisSimulation::applyInput(GameInput input)
+{
+	if (isAwaitingSpawn())
+	{
+		return;
+	}
+	if (recorder != nullptr)
+	{
+		recorder->recordInput(loopCount, input);
+	}
+	switch (input)
+	{
+	case GameInput::ROTATE:
+		attemptRotate(currentShape);
+		break;
+	case GameInput::RIGHT:
+		attemptMove(currentShape, 1, 0);
+		break;
+	case GameInput::LEFT:
+		attemptMove(currentShape, -1, 0);
+		break;
+	case GameInput::SOFT_DROP:
+		if (!attemptMove(currentShape, 0, 1)) {
+			lock(currentShape);
+		}
+		break;
+	case GameInput::HARD_DROP:
+		drop(currentShape);
+		lock(currentShape);
+		break;
+	default:
+		break;
+	}
+}
+
+// move the currentShape as far left or right as it can go in one move
+//   (recorded as the LEFT/RIGHT inputs it replaces)
+// - param 1: int direction, -1 for left, 1 for right
+// - return: the number of columns moved
+int TetrisSimulation::shiftToWall(int direction)
+{
+	if (isAwaitingSpawn())
+	{
+		return 0;	// the currentShape is locked, the next one hasn't spawned yet
+	}
+	const int distance = getShiftDistance(currentShape, direction);
+	if (recorder != nullptr)
+	{
+		const GameInput input = direction < 0 ? GameInput::LEFT : GameInput::RIGHT;
+		for (int i = 0; i < distance; i++)
+		{
+			recorder->recordInput(loopCount, input);
+		}
+	}
+	currentShape.move(direction < 0 ? -distance : distance, 0);
+	return distance;
+}
+
+// called every game loop to handle ticks & tetromino placement (locking)
+//   decides whether a gravity tick is due, then runs stepGameLoop()
+// - param 1: the time since the last loop
+// return: nothing
+void TetrisSimulation::processGameLoop(std::chrono::nanoseconds timeSinceLastLoop)
+{
+	timeSinceLastTick += timeSinceLastLoop;
+	const std::chrono::nanoseconds tickLength = getTickLength();
+	bool gravityTick = false;
+	if (timeSinceLastTick >= tickLength)
+	{
+		gravityTick = true;
+		timeSinceLastTick -= tickLength;
+	}
+	stepGameLoop(gravityTick);
+}
+
+// as above, with the time in seconds (rounded to the nearest nanosecond)
+// - param 1: float secondsSinceLastLoop
+// return: nothing
+void TetrisSimulation::processGameLoop(const float secondsSinceLastLoop)
+{
+	processGameLoop(std::chrono::nanoseconds(std::llround(secondsSinceLastLoop * 1e9)));
+}
+
+// run one game loop with the gravity decision already made
+// - param 1: bool gravityTick
+// - return: nothing
+void TetrisSimulation::stepGameLoop(bool gravityTick)
+{
+	if (gravityTick && !shapePlacedSinceLastGameLoop)	// a shape locked by this loop's inputs is already down
+	{
+		if (recorder != nullptr)
+		{
+			recorder->recordGravityTick(loopCount);
+		}
+		tick();
+	}
+	if (shapePlacedSinceLastGameLoop)
+	{
+		shapePlacedSinceLastGameLoop = false;
+		if (spawnNextShape())
+		{
+			Gameboard::CompletedRows completedRows;
+			const int rowsCleared = board.removeCompletedRows(lockedRowsTop, lockedRowsBottom, completedRows);
+			lockedRowsTop = 0;
+			lockedRowsBottom = -1;
+			if (rowsCleared > 0)
+			{
+				boardRevision++;
+			}
+			linesCleared += rowsCleared;
+			scoreRowsCleared(rowsCleared);
+			pickNextShape();
+		}
+		else {
+			gamesLost++;
+			reset();
+		}
+	}
+	loopCount++;
+	if (recorder != nullptr)
+	{
+		recorder->recordLoopEnd(*this);
+	}
+}
+
+// A tick() forces the currentShape to move (if there were no tick,
+// the currentShape would float in position forever). This should
+// call attemptMove() on the currentShape.  If not successful, lock() 
+// the currentShape (it can move no further).
+// - params: none
+// - return: nothing
+void TetrisSimulation::tick()
+{
+	if (!attemptMove(currentShape, 0, 1)) {
+		lock(currentShape);
+	}
+}
+
+// the time between gravity ticks (secondsPerTick in whole nanoseconds)
+// - params: none
+// - return: the tick length
+std::chrono::nanoseconds TetrisSimulation::getTickLength() const
+{
+	return std::chrono::nanoseconds(std::llround(secondsPerTick * 1e9));
+}
+
+// the game time left until the next gravity tick is due
+// - params: none
+// - return: the time, 0 if a tick is already due
+std::chrono::nanoseconds TetrisSimulation::getTimeUntilTick() const
+{
+	return std::max(getTickLength() - timeSinceLastTick, std::chrono::nanoseconds::zero());
+}
+
+int TetrisSimulation::getScore() const
+{
+	return score;
+}
+const Gameboard& TetrisSimulation::getBoard() const
+{
+	return board;
+}
+const GridTetromino& TetrisSimulation::getCurrentShape() const
+{
+	return currentShape;
+}
+const GridTetromino& TetrisSimulation::getNextShape() const
+{
+	return nextShape;
+}
+const PieceRandomizer& TetrisSimulation::getRandomizer() const
+{
+	return randomizer;
+}
+unsigned int TetrisSimulation::getBoardRevision() const
+{
+	return boardRevision;
+}
+
+// true between a lock() and the next processGameLoop()
+// - params: none
+// - return: bool
+bool TetrisSimulation::isAwaitingSpawn() const
+{
+	return shapePlacedSinceLastGameLoop;
+}
+
+// statistics for bots & trainers
+// - params: none
+// - return: the count
+int TetrisSimulation::getLinesCleared() const
+{
+	return linesCleared;
+}
+int TetrisSimulation::getPiecesLocked() const
+{
+	return piecesLocked;
+}
+int TetrisSimulation::getGamesLost() const
+{
+	return gamesLost;
+}
+
+// the number of game loops run since newGame()
+// - params: none
+// - return: the loop count
+unsigned long long TetrisSimulation::getLoopCount() const
+{
+	return loopCount;
+}
+
+// record every applyInput() and gravity tick from now on (nullptr stops recording)
+// - param 1: the ReplayRecorder
+// - return: nothing
+void TetrisSimulation::setRecorder(ReplayRecorder* recorder)
+{
+	this->recorder = recorder;
+}
+
+// copy the game state out
+// - param 1: the State to fill in
+// - return: nothing
+void TetrisSimulation::saveState(State& state) const
+{
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			state.cells[y][x] = static_cast<signed char>(board.getContent(x, y));
+		}
+	}
+	state.currentShape = currentShape.getShape();
+	state.currentRotation = currentShape.getRotation();
+	state.currentX = currentShape.getGridLoc().getX();
+	state.currentY = currentShape.getGridLoc().getY();
+	state.nextShape = nextShape.getShape();
+	state.awaitingSpawn = shapePlacedSinceLastGameLoop;
+	state.lockedRowsTop = lockedRowsTop;
+	state.lockedRowsBottom = lockedRowsBottom;
+	state.score = score;
+	state.linesCleared = linesCleared;
+	state.piecesLocked = piecesLocked;
+	state.gamesLost = gamesLost;
+	state.loopCount = loopCount;
+	state.randomizer = randomizer.getState();
+}
+
+// copy a saved game state back in
+//   restoring keeps the recorder and restarts the tick timer.
+// - param 1: the State
+// - return: false if the State isn't valid (see isStateValid()), the game is unchanged then
+bool TetrisSimulation::restoreState(const State& state)
+{
+	if (!isStateValid(state))
+	{
+		return false;
+	}
+	board.empty();
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			if (state.cells[y][x] != Gameboard::EMPTY_BLOCK)
+			{
+				board.setContent(x, y, state.cells[y][x]);
+			}
+		}
+	}
+	boardRevision++;
+	currentShape.setShape(state.currentShape);
+	for (int i = 0; i < state.currentRotation % Tetromino::ROTATION_COUNT; i++)
+	{
+		currentShape.rotateClockwise();
+	}
+	currentShape.setGridLoc(state.currentX, state.currentY);
+	nextShape.setShape(state.nextShape);
+	shapePlacedSinceLastGameLoop = state.awaitingSpawn;
+	lockedRowsTop = state.lockedRowsTop;
+	lockedRowsBottom = state.lockedRowsBottom;
+	score = state.score;
+	linesCleared = state.linesCleared;
+	piecesLocked = state.piecesLocked;
+	gamesLost = state.gamesLost;
+	loopCount = state.loopCount;
+	randomizer.setState(state.randomizer);
+	determineSecondsPerTick();
+	timeSinceLastTick = std::chrono::nanoseconds::zero();
+	return true;
+}
+
+// whether a State is one saveState() could have made, so it's safe to restore
+// - param 1: the State
+// - return: bool
+bool TetrisSimulation::isStateValid(const State& state)
+{
+	const int colorCount = static_cast<int>(TetColor::PURPLE) + 1;
+	if (static_cast<int>(state.currentShape) < 0 || static_cast<int>(state.currentShape) >= static_cast<int>(TetShape::COUNT)
+		|| static_cast<int>(state.nextShape) < 0 || static_cast<int>(state.nextShape) >= static_cast<int>(TetShape::COUNT)
+		|| state.currentRotation < 0 || !PieceRandomizer::isStateValid(state.randomizer))
+	{
+		return false;
+	}
+	Gameboard restored;
+	for (int y = 0; y < Gameboard::MAX_Y; y++)
+	{
+		for (int x = 0; x < Gameboard::MAX_X; x++)
+		{
+			const int content = state.cells[y][x];
+			if (content != Gameboard::EMPTY_BLOCK && (content < 0 || content >= colorCount))
+			{
+				return false;
+			}
+			restored.setContent(x, y, content);
+		}
+	}
+
+	// shapes spawn on the spawn row and only ever move down from there
+	GridTetromino current;
+	current.setShape(state.currentShape);
+	for (int i = 0; i < state.currentRotation % Tetromino::ROTATION_COUNT; i++)
+	{
+		current.rotateClockwise();
+	}
+	current.setGridLoc(state.currentX, state.currentY);
+	if (state.currentY < restored.getSpawnLoc().getY() || state.currentY >= Gameboard::MAX_Y)
+	{
+		return false;
+	}
+	if (!state.awaitingSpawn)
+	{
+		// nothing is locked between a spawn and the next lock
+		return isPositionLegal(restored, current) && state.lockedRowsTop == 0 && state.lockedRowsBottom == -1;
+	}
+	// the locked shape's blocks are on the board, its rows are waiting to be cleared
+	return isWithinBorders(current) && state.lockedRowsTop == state.currentY + current.getLayout().minY
+		&& state.lockedRowsBottom == state.currentY + current.getLayout().maxY;
+}
+
+// assign nextShape.setShape the randomizer's next shape
+// - params: none
+// - return: nothing
+void TetrisSimulation::pickNextShape()
+{
+	nextShape.setShape(randomizer.nextShape());
+}
+
+// copy the nextShape into the currentShape (through assignment)
+//   position the currentShape to its spawn location.
+// - params: none
+// - return: bool, true/false based on isPositionLegal()
+bool TetrisSimulation::spawnNextShape()
+{
+	currentShape = nextShape;
+	currentShape.setGridLoc(board.getSpawnLoc());
+	return isPositionLegal(currentShape);
+}
+
+// Test if a rotation is legal on the tetromino and if so, rotate it. 
+// - param 1: GridTetromino shape
+// - return: bool, true/false to indicate successful movement
+bool TetrisSimulation::attemptRotate(GridTetromino& shape) const
+{
+	GridTetromino temp{ shape };
+	temp.rotateClockwise();
+	if (isPositionLegal(temp))
+	{
+		shape.rotateClockwise();
+		return true;
+	}
+	return false;
+}
+
+// test if a move is legal on the tetromino, if so, move it.
+// - param 1: GridTetromino shape
+// - param 2: int x;
+// - param 3: int y;
+// - return: true/false to indicate successful movement
+bool TetrisSimulation::attemptMove(GridTetromino& shape, int x, int y) const
+{
+	GridTetromino temp{ shape };
+	temp.move(x, y);
+	if (isPositionLegal(temp))
+	{
+		shape.move(x, y);
+		return true;
+	}
+	return false;
+}
+
+// drops the tetromino vertically as far as it can 
+//   legally go, in one move of getDropDistance() rows.
+// - param 1: GridTetromino shape
+// - return: nothing;
+void TetrisSimulation::drop(GridTetromino& shape) const
+{
+	shape.move(0, getDropDistance(shape));
+}
+
+// how many rows a (legally placed) tetromino can fall before it lands.
+// - param 1: GridTetromino shape
+// - return: an int, the number of rows the shape can move down
+int TetrisSimulation::getDropDistance(const GridTetromino& shape) const
+{
+	return getDropDistance(board, shape);
+}
+
+int TetrisSimulation::getDropDistance(const Gameboard& board, const GridTetromino& shape)
+{
+	const TetrominoLayout& layout = shape.getLayout();
+	const Point gridLoc = shape.getGridLoc();
+	int distance = Gameboard::MAX_Y;
+	for (int column = 0; column <= layout.maxX - layout.minX; column++)
+	{
+		const int x = gridLoc.getX() + layout.minX + column;
+		const int bottom = gridLoc.getY() + layout.columnBottoms[column];
+		const int surface = Gameboard::MAX_Y - board.getColumnHeight(x);	// the column's highest block (or the floor)
+		int landing = surface;
+		if (bottom >= surface)
+		{
+			// under an overhang, find the first block below this one
+			landing = bottom + 1;
+			while (landing < Gameboard::MAX_Y && (board.getRowMask(landing) & (1 << x)) == 0)
+			{
+				landing++;
+			}
+		}
+		distance = std::min(distance, landing - bottom - 1);
+	}
+	return distance;
+}
+
+// how many columns a (legally placed) tetromino can move left or right
+// - param 1: GridTetromino shape
+// - param 2: int direction, -1 for left, 1 for right
+// - return: an int, the number of columns the shape can move
+int TetrisSimulation::getShiftDistance(const GridTetromino& shape, int direction) const
+{
+	return getShiftDistance(board, shape, direction);
+}
+
+int TetrisSimulation::getShiftDistance(const Gameboard& board, const GridTetromino& shape, int direction)
+{
+	const TetrominoLayout& layout = shape.getLayout();
+	const Point gridLoc = shape.getGridLoc();
+
+	// the shape's blocks as a bit mask per row (rows above the board can't collide)
+	unsigned int shapeRows[Tetromino::BLOCK_COUNT] = {};
+	for (const BlockOffset& block : layout.blocks)
+	{
+		shapeRows[block.y - layout.minY] |= 1u << (gridLoc.getX() + block.x);
+	}
+
+	// the walls limit the distance, then slide the masks a column at a time until a block is hit
+	const int limit = direction < 0 ? gridLoc.getX() + layout.minX : Gameboard::MAX_X - 1 - (gridLoc.getX() + layout.maxX);
+	for (int distance = 1; distance <= limit; distance++)
+	{
+		for (int row = 0; row <= layout.maxY - layout.minY; row++)
+		{
+			const int y = gridLoc.getY() + layout.minY + row;
+			if (y < 0)
+			{
+				continue;
+			}
+			const unsigned int shifted = direction < 0 ? shapeRows[row] >> distance : shapeRows[row] << distance;
+			if ((board.getRowMask(y) & shifted) != 0)
+			{
+				return distance - 1;
+			}
+		}
+	}
+	return std::max(limit, 0);
+}
+
+// copy the contents (color) of the tetromino's mapped block locs to the grid.
+// - param 1: GridTetromino shape
+// - return: nothing
+void TetrisSimulation::lock(const GridTetromino& shape)
+{
+	board.setContent(shape.getBlockLocsMappedToGrid(), static_cast<int>(shape.getColor()));
+	boardRevision++;
+	piecesLocked++;
+
+	const int top = shape.getGridLoc().getY() + shape.getLayout().minY;
+	const int bottom = shape.getGridLoc().getY() + shape.getLayout().maxY;
+	if (shapePlacedSinceLastGameLoop)
+	{
+		lockedRowsTop = std::min(lockedRowsTop, top);
+		lockedRowsBottom = std::max(lockedRowsBottom, bottom);
+	}
+	else {
+		lockedRowsTop = top;
+		lockedRowsBottom = bottom;
+	}
+	shapePlacedSinceLastGameLoop = true;
+}
+
+// add to the score for a number of rows cleared at once
+// - param 1: int the number of rows cleared
+// - return: nothing
+void TetrisSimulation::scoreRowsCleared(int rowCount)
+{
+	switch (rowCount)
+	{
+	case 1:
+		score += SINGLE_LINE;
+		break;
+	case 2:
+		score += DOUBLE_LINE;
+		break;
+	case 3:
+		score += TRIPLE_LINE;
+		break;
+	case 4:
+		score += TETRIS_LINE;
+		break;
+	default:
+		break;
+	}
+}
+
+// Determine if a Tetromino can legally be placed at its current position
+// on the gameboard.
+// - param 1: GridTetromino shape
+// - return: bool, true if shape is within borders (isWithinBorders()) and 
+//           the shape's mapped board locs are empty (false otherwise).
+bool TetrisSimulation::isPositionLegal(const GridTetromino& shape) const
+{
+	return isPositionLegal(board, shape);
+}
+
+bool TetrisSimulation::isPositionLegal(const Gameboard& board, const GridTetromino& shape)
+{
+	return isWithinBorders(shape) && board.areAllLocsEmpty(shape.getBlockLocsMappedToGrid());
+}
+
+// Determine if the shape is within the left, right, & bottom gameboard borders
+//   * Ignore the upper border because we want shapes to be able to drop
+//     in from the top of the gameboard.
+// - param 1: GridTetromino shape
+// - return: bool, true if the shape is within the left, right, and lower border
+//	         of the grid, but *NOT* the top border (false otherwise)
+bool TetrisSimulation::isWithinBorders(const GridTetromino& shape)
+{
+	const TetrominoLayout& layout = shape.getLayout();
+	const Point gridLoc = shape.getGridLoc();
+	return gridLoc.getX() + layout.minX >= 0 &&
+		gridLoc.getX() + layout.maxX < Gameboard::MAX_X &&
+		gridLoc.getY() + layout.maxY < Gameboard::MAX_Y;
+}
+
+// set secsPerTick 
+//   - basic: use MAX_SECS_PER_TICK
+//   - advanced: base it on score (higher score results in lower secsPerTick)
+// params: none
+// return: nothing
+void TetrisSimulation::determineSecondsPerTick()
+{
+	secondsPerTick = MAX_SECONDS_PER_TICK;
+}
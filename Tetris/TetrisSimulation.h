@@ -0,0 +1,350 @@
+// This class holds the rules of a single tetris game, with no graphics
+// or windowing dependencies, so it can be run headless (bots, servers, tests).
+// 
+// This class is responsible for:
+//   - setting up the board,
+//   - spawning tetrominoes,
+//   - applying player inputs,
+//   - gravity ticks, moving and placing (locking) tetrominoes,
+//   - clearing rows and keeping score
+//
+// TetrisGame wraps one of these to draw it and feed it keyboard input.
+
+#ifndef TETRISSIMULATION_H
+#define TETRISSIMULATION_H
+
+#include "Gameboard.h"
+#include "GridTetromino.h"
+#include "PieceRandomizer.h"
+#include <chrono>
+
+// the things a player can do to the falling tetromino
+enum class GameInput { ROTATE, LEFT, RIGHT, SOFT_DROP, HARD_DROP, COUNT };
+
+class ReplayRecorder;
+
+class TetrisSimulation
+{
+public:
+	// STATIC CONSTANTS
+	static const double MAX_SECONDS_PER_TICK; // the slowest "tick" rate (in seconds), init to 0.75
+	static const double MIN_SECONDS_PER_TICK; // the fastest "tick" rate (in seconds), init to 0.20
+	static const int SINGLE_LINE{ 40 };
+	static const int DOUBLE_LINE{ 100 };
+	static const int TRIPLE_LINE{ 300 };
+	static const int TETRIS_LINE{ 1200 };
+
+	// everything needed to continue a game exactly (see saveState()).
+	// The tick timer isn't included, it follows the wall clock rather than the game
+	// (replays record the gravity ticks themselves).
+	struct State
+	{
+		signed char cells[Gameboard::MAX_Y][Gameboard::MAX_X];	// the board content
+		TetShape currentShape;
+		int currentRotation;
+		int currentX;
+		int currentY;
+		TetShape nextShape;
+		bool awaitingSpawn;			// see isAwaitingSpawn()
+		int lockedRowsTop;
+		int lockedRowsBottom;
+		int score;
+		int linesCleared;
+		int piecesLocked;
+		int gamesLost;
+		unsigned long long loopCount;
+		PieceRandomizer::State randomizer;
+	};
+
+private:
+	// MEMBER VARIABLES
+
+	// State members ---------------------------------------------
+	PieceRandomizer randomizer;	// deals this game's shapes (seeded per game)
+	int score;					// the current game score.
+	Gameboard board;			// the gameboard (grid) to represent where all the blocks are.
+	GridTetromino nextShape;	// the tetromino shape that is "on deck".
+	GridTetromino currentShape;	// the tetromino that is currently falling.
+
+	// Time members ----------------------------------------------
+	// Note: a "tick" is the amount of time it takes a block to fall one line.
+	double secondsPerTick = MAX_SECONDS_PER_TICK; // the seconds per tick (changes depending on score)	
+
+	std::chrono::nanoseconds timeSinceLastTick{ 0 };	// update this every game loop until it is >= getTickLength(),
+												// we then know to trigger a tick.  Reduce this var (by a tick) & repeat.
+	bool shapePlacedSinceLastGameLoop{ false };	// Tracks whether we have placed (locked) a shape on
+												// the gameboard in the current gameloop	
+	int lockedRowsTop{ 0 };						// the rows touched by shapes locked since the last
+	int lockedRowsBottom{ -1 };					// game loop, the only rows that can have been completed
+	unsigned int boardRevision{ 0 };			// bumped every time the board content changes
+
+	// Statistics members ----------------------------------------
+	int linesCleared{ 0 };						// rows cleared this game
+	int piecesLocked{ 0 };						// shapes locked this game
+	int gamesLost{ 0 };							// games ended by topping out since newGame()
+
+	// Replay members --------------------------------------------
+	unsigned long long loopCount{ 0 };			// game loops run since newGame(), the replay time base
+	ReplayRecorder* recorder{ nullptr };		// records inputs & gravity ticks when set
+public:
+	// MEMBER FUNCTIONS
+
+	// constructor
+	//   seed the randomizer, reset() the game
+	// - param 1: the randomizer seed (the same seed & inputs replay the same game)
+	// - param 2: the RandomizerMode
+	TetrisSimulation(std::uint64_t seed = 1, RandomizerMode mode = RandomizerMode::BAG);
+
+	// reseed the randomizer and reset() the game
+	// - param 1: the randomizer seed
+	// - param 2: the RandomizerMode
+	// - return: nothing
+	void newGame(std::uint64_t seed, RandomizerMode mode);
+
+	// reset everything for a new game (use existing functions) 
+	//  - set the score (and lines & pieces) to 0
+	//  - call determineSecondsPerTick() to determine the tick rate.
+	//  - clear the gameboard,
+	//  - pick & spawn next shape
+	//  - pick next shape again (for the "on-deck" shape)
+	// - params: none
+	// - return: nothing
+	void reset();
+
+	// apply a player input to the currentShape
+	//   ROTATE: attemptRotate()
+	//   LEFT/RIGHT: attemptMove() one column
+	//   SOFT_DROP: attemptMove() one row down, lock() if it can't move
+	//   HARD_DROP: drop() then lock()
+	// Inputs are ignored (and not recorded) while isAwaitingSpawn(), as the
+	// currentShape has already been locked onto the board.
+	// - param 1: GameInput input
+	// - return: nothing
+	void applyInput(GameInput input);
+
+	// move the currentShape as far left or right as it can go in one move of
+	// getShiftDistance() columns (ARR 0 auto shift). It's recorded as that many
+	// LEFT/RIGHT inputs, which is what repeating the input until it failed would do.
+	// - param 1: int direction, -1 for left, 1 for right
+	// - return: the number of columns moved
+	int shiftToWall(int direction);
+
+	// called every game loop to handle ticks & tetromino placement (locking)
+	//   decides whether a gravity tick is due, then runs stepGameLoop()
+	//   The time is kept in whole nanoseconds, so a fixed loop length
+	//   (see TickScheduler) ticks after exactly the same loops every time.
+	// - param 1: the time since the last loop
+	// return: nothing
+	void processGameLoop(std::chrono::nanoseconds timeSinceLastLoop);
+
+	// as above, with the time in seconds (rounded to the nearest nanosecond)
+	// - param 1: float secondsSinceLastLoop
+	// return: nothing
+	void processGameLoop(const float secondsSinceLastLoop);
+
+	// run one game loop with the gravity decision already made:
+	//   tick() if gravityTick (unless a shape was locked since the last loop), then spawn
+	//   the next shape & clear rows if one was.
+	// Everything that changes the game between newGame() calls is an
+	// applyInput() or a stepGameLoop(), which is what makes replays exact.
+	// - param 1: bool gravityTick
+	// - return: nothing
+	void stepGameLoop(bool gravityTick);
+
+	// A tick() forces the currentShape to move (if there were no tick,
+	// the currentShape would float in position forever). This should
+	// call attemptMove() on the currentShape.  If not successful, lock() 
+	// the currentShape (it can move no further).
+	// - params: none
+	// - return: nothing
+	void tick();
+
+	// the time between gravity ticks (secondsPerTick in whole nanoseconds)
+	// - params: none
+	// - return: the tick length
+	std::chrono::nanoseconds getTickLength() const;
+
+	// the game time left until the next gravity tick is due
+	//   (processGameLoop() calls adding up to this much will tick)
+	// - params: none
+	// - return: the time, 0 if a tick is already due
+	std::chrono::nanoseconds getTimeUntilTick() const;
+
+	// getters for the game state
+	int getScore() const;
+	const Gameboard& getBoard() const;
+	const GridTetromino& getCurrentShape() const;
+	const GridTetromino& getNextShape() const;
+	const PieceRandomizer& getRandomizer() const;
+
+	// a counter that changes whenever the locked board content changes
+	// (a shape is locked, rows are removed or the game is reset).
+	// Renderers compare it with the revision they last drew to know when to redraw the board.
+	// - params: none
+	// - return: the board revision
+	unsigned int getBoardRevision() const;
+
+	// statistics for bots & trainers
+	//   getLinesCleared(): rows cleared this game
+	//   getPiecesLocked(): shapes locked this game
+	//   getGamesLost(): games ended by topping out (which reset() the game) since newGame()
+	// - params: none
+	// - return: the count
+	int getLinesCleared() const;
+	int getPiecesLocked() const;
+	int getGamesLost() const;
+
+	// true between a lock() and the next processGameLoop(), while the locked
+	// shape is still the currentShape and the next one hasn't spawned yet
+	// - params: none
+	// - return: bool
+	bool isAwaitingSpawn() const;
+
+	// the number of game loops run since newGame()
+	// - params: none
+	// - return: the loop count
+	unsigned long long getLoopCount() const;
+
+	// record every applyInput() and gravity tick from now on (nullptr stops recording)
+	//   the recorder should be opened with this game's seed right after newGame()
+	// - param 1: the ReplayRecorder, it must outlive the recording
+	// - return: nothing
+	void setRecorder(ReplayRecorder* recorder);
+
+	// copy the game state out / back in (eg: replay keyframes, seeking)
+	//   restoring keeps the recorder and restarts the tick timer.
+	// - param 1: the State
+	// - return: (restore) false if the State isn't valid (see isStateValid()),
+	//           the game is unchanged then
+	void saveState(State& state) const;
+	bool restoreState(const State& state);
+
+	// whether a State is one saveState() could have made, so it's safe to restore:
+	//   the shapes, rotation, block colors & randomizer state are in range,
+	//   the currentShape is at or below the spawn row and legally placed (or
+	//   within the borders, if it's locked & awaiting spawn), and the locked
+	//   rows are the empty range (0, -1), or the locked shape's rows if awaiting spawn
+	// - param 1: the State
+	// - return: bool
+	static bool isStateValid(const State& state);
+
+	// Gameplay primitives ===========================================
+
+	// Test if a rotation is legal on the tetromino and if so, rotate it. 
+	//  To accomplish this:
+	//	 1) create a (local) temporary copy of the tetromino
+	//	 2) rotate it (temp.rotateClockwise())
+	//	 3) test if temp rotation was legal (isPositionLegal()), 
+	//      if so - rotate the original tetromino.
+	// - param 1: GridTetromino shape
+	// - return: bool, true/false to indicate successful movement
+	bool attemptRotate(GridTetromino& shape) const;
+
+	// test if a move is legal on the tetromino, if so, move it.
+	//  To do this:
+	//	 1) create a (local) temporary copy of the tetromino
+	//	 2) move it (temp.move())
+	//	 3) test if temp move was legal (isPositionLegal(),
+	//      if so - move the original.	
+	// - param 1: GridTetromino shape
+	// - param 2: int x;
+	// - param 3: int y;
+	// - return: true/false to indicate successful movement
+	bool attemptMove(GridTetromino& shape, int x, int y) const;
+
+	// drops the tetromino vertically as far as it can 
+	//   legally go, in one move of getDropDistance() rows.
+	// - param 1: GridTetromino shape
+	// - return: nothing;
+	void drop(GridTetromino& shape) const;
+
+	// how many rows a (legally placed) tetromino can fall before it lands.
+	//   For each column the shape covers, compare the shape's lowest block
+	//   (TetrominoLayout::columnBottoms) with the board's surface in that column
+	//   (Gameboard::getColumnHeight()). Only a column where the shape is already
+	//   below the surface (tucked under an overhang) has to scan the row masks.
+	// - param 1: GridTetromino shape
+	// - return: an int, the number of rows the shape can move down
+	int getDropDistance(const GridTetromino& shape) const;
+
+	// Same as above, against any gameboard
+	// - param 1: Gameboard board
+	// - param 2: GridTetromino shape
+	// - return: an int, the number of rows the shape can move down
+	static int getDropDistance(const Gameboard& board, const GridTetromino& shape);
+
+	// how many columns a (legally placed) tetromino can move left or right
+	//   before it hits a wall or a block.
+	//   The shape's blocks are turned into a bit mask per row, which is
+	//   slid across and tested against the board's row masks (Gameboard::getRowMask()).
+	// - param 1: GridTetromino shape
+	// - param 2: int direction, -1 for left, 1 for right
+	// - return: an int, the number of columns the shape can move
+	int getShiftDistance(const GridTetromino& shape, int direction) const;
+
+	// Same as above, against any gameboard
+	// - param 1: Gameboard board
+	// - param 2: GridTetromino shape
+	// - param 3: int direction, -1 for left, 1 for right
+	// - return: an int, the number of columns the shape can move
+	static int getShiftDistance(const Gameboard& board, const GridTetromino& shape, int direction);
+
+	// Determine if a Tetromino can legally be placed at its current position
+	// on the gameboard.
+	// - param 1: GridTetromino shape
+	// - return: bool, true if shape is within borders (isWithinBorders()) and 
+	//           the shape's mapped board locs are empty (false otherwise).
+	bool isPositionLegal(const GridTetromino& shape) const;
+
+	// Same test as above, against any gameboard
+	// (lets analysis tools and bots share the game's rules)
+	// - param 1: Gameboard board
+	// - param 2: GridTetromino shape
+	// - return: bool, true if the shape could legally be placed on the board
+	static bool isPositionLegal(const Gameboard& board, const GridTetromino& shape);
+
+private:
+	// assign nextShape.setShape the randomizer's next shape
+	// - params: none
+	// - return: nothing
+	void pickNextShape();
+	
+	// copy the nextShape into the currentShape (through assignment)
+	//   position the currentShape to its spawn location.
+	// - params: none
+	// - return: bool, true/false based on isPositionLegal()
+	bool spawnNextShape();																	
+
+	// copy the contents (color) of the tetromino's mapped block locs to the grid.
+	//	 1) get the tetromino's mapped locs via tetromino.getBlockLocsMappedToGrid()
+	//   2) use the board's setContent() method to set the content at the mapped locations.
+	//   3) record the fact that we placed a shape by setting shapePlacedSinceLastGameLoop
+	//      to true, and which rows it touched (lockedRowsTop/Bottom)
+	// - param 1: GridTetromino shape
+	// - return: nothing
+	void lock(const GridTetromino& shape);
+
+	// add to the score for a number of rows cleared at once
+	// - param 1: int the number of rows cleared
+	// - return: nothing
+	void scoreRowsCleared(int rowCount);
+
+	// Determine if the shape is within the left, right, & bottom gameboard borders
+	//   * Ignore the upper border because we want shapes to be able to drop
+	//     in from the top of the gameboard.
+	//   All of a shape's blocks must be inside these 3 borders to return true
+	// - param 1: GridTetromino shape
+	// - return: bool, true if the shape is within the left, right, and lower border
+	//	         of the grid, but *NOT* the top border (false otherwise)
+	static bool isWithinBorders(const GridTetromino& shape);
+
+	// set secsPerTick 
+	//   - basic: use MAX_SECS_PER_TICK
+	//   - advanced: base it on score (higher score results in lower secsPerTick)
+	// params: none
+	// return: nothing
+	void determineSecondsPerTick();
+	friend class TestSuite;
+};
+
+#endif /* TETRISSIMULATION_H */
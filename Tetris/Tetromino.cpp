@@ -1,13 +1,104 @@
 #include "Tetromino.h"
 #include <iostream>
-#include <ctime>
+
+namespace
+{
+	const int SHAPE_COUNT = static_cast<int>(TetShape::COUNT);
+
+	struct RotationTable
+	{
+		TetrominoLayout layouts[SHAPE_COUNT][Tetromino::ROTATION_COUNT];
+	};
+
+	// the spawn (rotation 0) layout of each shape, in TetShape order
+	constexpr BlockOffset SPAWN_BLOCKS[SHAPE_COUNT][Tetromino::BLOCK_COUNT] = {
+		{ {0, 0}, {-1, 0}, {0, 1}, {1, 1} },	// S
+		{ {0, 0}, {0, 1}, {-1, 1}, {1, 0} },	// Z
+		{ {0, 0}, {0, -1}, {1, -1}, {0, 1} },	// L
+		{ {0, 0}, {0, -1}, {-1,-1}, {0, 1} },	// J
+		{ {0, 0}, {1, 1}, {0, 1}, {1, 0} },		// O
+		{ {0, 0}, {0, -1}, {0, 1}, {0, 2} },	// I
+		{ {0, 0}, {-1, 0}, {1, 0}, {0, -1} }	// T
+	};
+
+	// fill in a layout's bounding box and column bottoms from its blocks
+	constexpr void computeBounds(TetrominoLayout& layout)
+	{
+		layout.minX = layout.maxX = layout.blocks[0].x;
+		layout.minY = layout.maxY = layout.blocks[0].y;
+		for (const BlockOffset& block : layout.blocks)
+		{
+			layout.minX = block.x < layout.minX ? block.x : layout.minX;
+			layout.maxX = block.x > layout.maxX ? block.x : layout.maxX;
+			layout.minY = block.y < layout.minY ? block.y : layout.minY;
+			layout.maxY = block.y > layout.maxY ? block.y : layout.maxY;
+		}
+		for (int& bottom : layout.columnBottoms)
+		{
+			bottom = layout.minY;
+		}
+		for (const BlockOffset& block : layout.blocks)
+		{
+			int& bottom = layout.columnBottoms[block.x - layout.minX];
+			bottom = block.y > bottom ? block.y : bottom;
+		}
+	}
+
+	// build every (shape, rotation) layout.
+	// a clockwise rotation maps [x,y] to [y,-x] (the old multiplyX(-1), swapXY()).
+	// The O shape doesn't rotate, so all of its entries are the spawn layout.
+	constexpr RotationTable buildRotationTable()
+	{
+		RotationTable table{};
+		for (int shape = 0; shape < SHAPE_COUNT; shape++)
+		{
+			for (int i = 0; i < Tetromino::BLOCK_COUNT; i++)
+			{
+				table.layouts[shape][0].blocks[i] = SPAWN_BLOCKS[shape][i];
+			}
+			computeBounds(table.layouts[shape][0]);
+
+			for (int rotation = 1; rotation < Tetromino::ROTATION_COUNT; rotation++)
+			{
+				const TetrominoLayout& previous = table.layouts[shape][rotation - 1];
+				TetrominoLayout& layout = table.layouts[shape][rotation];
+				for (int i = 0; i < Tetromino::BLOCK_COUNT; i++)
+				{
+					if (shape == static_cast<int>(TetShape::O))
+					{
+						layout.blocks[i] = previous.blocks[i];
+					}
+					else {
+						layout.blocks[i] = BlockOffset{ previous.blocks[i].y, -previous.blocks[i].x };
+					}
+				}
+				computeBounds(layout);
+			}
+		}
+		return table;
+	}
+
+	constexpr RotationTable ROTATION_TABLE = buildRotationTable();
+
+	// spot check the table at compile time
+	constexpr const TetrominoLayout& I_VERTICAL = ROTATION_TABLE.layouts[static_cast<int>(TetShape::I)][0];
+	constexpr const TetrominoLayout& I_HORIZONTAL = ROTATION_TABLE.layouts[static_cast<int>(TetShape::I)][1];
+	static_assert(I_VERTICAL.minY == -1 && I_VERTICAL.maxY == 2 && I_VERTICAL.minX == 0 && I_VERTICAL.maxX == 0,
+		"I shape should spawn vertically");
+	static_assert(I_HORIZONTAL.minX == -1 && I_HORIZONTAL.maxX == 2 && I_HORIZONTAL.minY == 0 && I_HORIZONTAL.maxY == 0,
+		"a rotated I shape should be horizontal");
+	constexpr const TetrominoLayout& T_SPAWN = ROTATION_TABLE.layouts[static_cast<int>(TetShape::T)][0];
+	static_assert(T_SPAWN.columnBottoms[0] == 0 && T_SPAWN.columnBottoms[1] == 0 && T_SPAWN.columnBottoms[2] == 0,
+		"T shape should spawn flat side down");
+}
+
 Tetromino::Tetromino()
 {
 	setShape(TetShape::L);
 }
 TetColor Tetromino::getColor() const
 {
-	return color;
+	return static_cast<TetColor>(shape);
 }
 TetShape Tetromino::getShape() const
 {
@@ -15,83 +106,42 @@ TetShape Tetromino::getShape() const
 }
 void Tetromino::setShape(TetShape shape)
 {
-
 	this->shape = shape;
-	color = static_cast<TetColor>(shape);
-	switch (shape)
-	{
-		case TetShape::O:
-		{
-			blockLocs = { Point{0, 0}, Point{1, 1}, Point{0, 1}, Point{1, 0} };
-			break;
-		}
-		case TetShape::I:
-		{
-			blockLocs = { Point{0, 0}, Point{0, -1}, Point{0, 1}, Point{0, 2} };
-			break;
-		}
-		case TetShape::S:
-		{
-			blockLocs = { Point{0, 0}, Point{-1, 0}, Point{0, 1}, Point{1, 1} };
-			break;
-		}
-		case TetShape::Z:
-		{
-			blockLocs = { Point{0, 0}, Point{0, 1}, Point{-1, 1}, Point{1, 0} };
-			break;
-		}
-		case TetShape::L:
-		{
-			blockLocs = { Point{0, 0}, Point{0, -1}, Point{1, -1}, Point{0, 1} };
-			break;
-		}
-		case TetShape::J:
-		{
-			blockLocs = { Point{0, 0}, Point{0, -1}, Point{-1,-1}, Point{0, 1} };
-			break;
-		}
-		case TetShape::T:
-		{
-			blockLocs = { Point{0, 0}, Point{-1, 0}, Point{1, 0}, Point{0, -1} };
-			break;
-		}
-	}
+	rotation = 0;
 }
-TetShape Tetromino::getRandomShape(){
-	
-	int randShape = rand() % static_cast<int>(TetShape::COUNT);
-	return static_cast<TetShape>(randShape);
+int Tetromino::getRotation() const
+{
+	return rotation;
+}
+const TetrominoLayout& Tetromino::getLayout() const
+{
+	return ROTATION_TABLE.layouts[static_cast<int>(shape)][rotation];
+}
+const TetrominoLayout& Tetromino::getLayout(TetShape shape, int rotation)
+{
+	return ROTATION_TABLE.layouts[static_cast<int>(shape)][rotation];
 }
 void Tetromino::rotateClockwise()
 {
-	for (Point& point : blockLocs) {
-		point.multiplyX(-1);
-		point.swapXY();
-	}
+	rotation = (rotation + 1) % ROTATION_COUNT;
 }
 void Tetromino::printToConsole() const
 {
-
-	for (int y = 3; y >= -3; y--)
+	const TetrominoLayout& layout = getLayout();
+	for (int y = -3; y <= 3; y++)
 	{
 		std::cout << '\n';
 		for (int x = -3; x <= 3; x++)
 		{
 			char entry = '.';
-			for (Point point : blockLocs) {
-				point.multiplyX(-1);
-				point.swapXY();
-				if (point.getX() == x and point.getY() == y)
+			for (const BlockOffset& block : layout.blocks) {
+				if (block.x == x && block.y == y)
 				{
 					entry = 'x';
 				}
 			}
 			std::cout << entry;
-			
-
 		}
 	}
 	std::cout << '\n';
-
-	//std::cout << Tetromino::blockLocs[0].toString();
-}
\ No newline at end of file
+}
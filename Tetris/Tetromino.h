@@ -1,24 +1,72 @@
 #pragma once
-#include <vector>
+#include <array>
 #include "Point.h"
 
 enum class TetShape { S, Z, L, J, O, I, T, COUNT};
 enum class TetColor {RED, ORANGE, YELLOW, GREEN, BLUE_LIGHT, BLUE_DARK, PURPLE};
+
+// a block's offset from the tetromino's pivot block (0,0)
+struct BlockOffset
+{
+	int x;
+	int y;
+};
+
+// the blocks of a tetromino in one rotation, plus the bounding box around them
+// (the bounding box is relative to the pivot block, like the offsets)
+// columnBottoms holds the lowest block's y offset in each column of the
+// bounding box (columnBottoms[0] is column minX), used to drop without stepping.
+struct TetrominoLayout
+{
+	BlockOffset blocks[4];
+	int minX;
+	int maxX;
+	int minY;
+	int maxY;
+	int columnBottoms[4];
+};
+
+// A tetromino is just a shape and a rotation index.
+// The block layouts for every (shape, rotation) are built at compile time
+// (see Tetromino.cpp), so changing shape or rotating never allocates.
 class Tetromino
 {
+public:
+	static const int BLOCK_COUNT = 4;		// # of blocks in a tetromino
+	static const int ROTATION_COUNT = 4;	// # of entries in each shape's rotation table
+
 private:
-	TetColor color;
 	TetShape shape;
-	std::vector<Point> blockLocs;
+	int rotation;	// index into the rotation table, [0, ROTATION_COUNT)
 public:
 	Tetromino();
 	TetColor getColor() const;
 	TetShape getShape() const;
+
+	// set the shape and reset it to its spawn rotation (0)
 	void setShape(TetShape shape);
+
+	// get the current rotation index
+	// - return: an int in [0, ROTATION_COUNT)
+	int getRotation() const;
+
+	// step to the next clockwise rotation in the table
 	void rotateClockwise();
+
+	// get the block layout of the current shape and rotation
+	// - return: a reference into the static rotation table
+	const TetrominoLayout& getLayout() const;
+
+	// get the block layout of any shape and rotation
+	// - param 1: the TetShape
+	// - param 2: the rotation index, [0, ROTATION_COUNT)
+	// - return: a reference into the static rotation table
+	static const TetrominoLayout& getLayout(TetShape shape, int rotation);
+
 	void printToConsole() const;
-	static TetShape getRandomShape();
 	friend class TestSuite;
 	friend class GridTetromino;
 };
 
+// the block locations of a single tetromino, sized to live on the stack
+using BlockLocs = std::array<Point, Tetromino::BLOCK_COUNT>;
@@ -0,0 +1,98 @@
+#include "TickScheduler.h"
+#include <cassert>
+
+const std::chrono::nanoseconds TickScheduler::DEFAULT_STEP_LENGTH{ std::chrono::milliseconds(10) };
+
+// constructor
+// - param 1: the length of a step, must be > 0
+// - param 2: the most steps a single advance() returns, must be > 0
+TickScheduler::TickScheduler(std::chrono::nanoseconds stepLength, int maxSteps)
+	: stepLength{ stepLength }, maxSteps{ maxSteps }
+{
+	assert(stepLength.count() > 0 && "TickScheduler step length must be > 0");
+	assert(maxSteps > 0 && "TickScheduler maxSteps must be > 0");
+}
+
+// bank the time since the last call, and take the steps now owed
+//   any owed time past maxSteps steps is dropped (see getDroppedTime())
+// - param 1: the wall time since the last advance() (negative counts as 0)
+// - return: the number of steps to run now, 0 to maxSteps
+int TickScheduler::advance(std::chrono::nanoseconds elapsed)
+{
+	if (elapsed.count() > 0)
+	{
+		pendingTime += elapsed;
+	}
+	const long long owed = pendingTime / stepLength;
+	pendingTime -= owed * stepLength;
+
+	int steps = static_cast<int>(owed);
+	if (owed > maxSteps)
+	{
+		steps = maxSteps;
+		droppedTime += (owed - maxSteps) * stepLength;
+		dropCount++;
+	}
+	stepCount += steps;
+	return steps;
+}
+
+// forget the banked time (eg: after a pause), the counters are kept
+// - params: none
+// - return: nothing
+void TickScheduler::clearPending()
+{
+	pendingTime = std::chrono::nanoseconds::zero();
+}
+
+// - return: the length of a step
+std::chrono::nanoseconds TickScheduler::getStepLength() const
+{
+	return stepLength;
+}
+
+// - return: the most steps a single advance() returns
+int TickScheduler::getMaxSteps() const
+{
+	return maxSteps;
+}
+
+// banked time that's less than a step (how far into the next step we are)
+// - return: the pending time, 0 to stepLength - 1
+std::chrono::nanoseconds TickScheduler::getPendingTime() const
+{
+	return pendingTime;
+}
+
+// the time until the next step is owed
+// - return: stepLength - getPendingTime()
+std::chrono::nanoseconds TickScheduler::getTimeUntilNextStep() const
+{
+	return stepLength - pendingTime;
+}
+
+// the time until a number of steps are owed (eg: to sleep until then)
+// - param 1: int the number of steps
+// - return: steps * stepLength - getPendingTime()
+std::chrono::nanoseconds TickScheduler::getTimeUntilSteps(int steps) const
+{
+	return steps * stepLength - pendingTime;
+}
+
+// totals since construction
+// - params: none
+// - return: the total
+unsigned long long TickScheduler::getStepCount() const
+{
+	return stepCount;
+}
+
+std::chrono::nanoseconds TickScheduler::getDroppedTime() const
+{
+	return droppedTime;
+}
+
+unsigned long long TickScheduler::getDropCount() const
+{
+	return dropCount;
+}
@@ -0,0 +1,80 @@
+// Turns wall clock time into a whole number of fixed length simulation steps.
+//
+// The game advances in steps of exactly getStepLength() (10 ms by default),
+// however long the frames are: advance() banks each frame's elapsed time
+// and hands back the number of whole steps now owed, carrying the remainder
+// to the next frame. All time is kept in integer nanoseconds, so no rounding
+// error builds up, and the same wall time always makes the same number of
+// steps on a fast or a slow machine.
+//
+// After a long stall (a window drag, a debugger break) catching up on every
+// owed step would freeze the game while it fast forwards, so advance() runs
+// at most getMaxSteps() at a time and drops the rest of the owed time.
+// Dropped time is counted, for reporting.
+
+#ifndef TICKSCHEDULER_H
+#define TICKSCHEDULER_H
+
+#include <chrono>
+
+class TickScheduler
+{
+public:
+	static const std::chrono::nanoseconds DEFAULT_STEP_LENGTH;	// 10 ms, 100 steps a second
+	static const int DEFAULT_MAX_STEPS{ 25 };	// catch up on at most 250 ms (at the default step) at once
+
+	// constructor
+	// - param 1: the length of a step, must be > 0
+	// - param 2: the most steps a single advance() returns, must be > 0
+	explicit TickScheduler(std::chrono::nanoseconds stepLength = DEFAULT_STEP_LENGTH, int maxSteps = DEFAULT_MAX_STEPS);
+
+	// bank the time since the last call, and take the steps now owed
+	//   any owed time past maxSteps steps is dropped (see getDroppedTime())
+	// - param 1: the wall time since the last advance() (negative counts as 0)
+	// - return: the number of steps to run now, 0 to maxSteps
+	int advance(std::chrono::nanoseconds elapsed);
+
+	// forget the banked time (eg: after a pause), the counters are kept
+	// - params: none
+	// - return: nothing
+	void clearPending();
+
+	// - return: the length of a step
+	std::chrono::nanoseconds getStepLength() const;
+
+	// - return: the most steps a single advance() returns
+	int getMaxSteps() const;
+
+	// banked time that's less than a step (how far into the next step we are)
+	// - return: the pending time, 0 to stepLength - 1
+	std::chrono::nanoseconds getPendingTime() const;
+
+	// the time until the next step is owed
+	// - return: stepLength - getPendingTime()
+	std::chrono::nanoseconds getTimeUntilNextStep() const;
+
+	// the time until a number of steps are owed (eg: to sleep until then)
+	// - param 1: int the number of steps
+	// - return: steps * stepLength - getPendingTime()
+	std::chrono::nanoseconds getTimeUntilSteps(int steps) const;
+
+	// totals since construction
+	//   getStepCount(): the steps returned by advance()
+	//   getDroppedTime(): the owed time discarded by the maxSteps cap
+	//   getDropCount(): the advance() calls that hit the cap
+	// - params: none
+	// - return: the total
+	unsigned long long getStepCount() const;
+	std::chrono::nanoseconds getDroppedTime() const;
+	unsigned long long getDropCount() const;
+
+private:
+	const std::chrono::nanoseconds stepLength;
+	const int maxSteps;
+	std::chrono::nanoseconds pendingTime{ 0 };		// banked time not yet turned into steps
+	unsigned long long stepCount{ 0 };
+	std::chrono::nanoseconds droppedTime{ 0 };
+	unsigned long long dropCount{ 0 };
+};
+
+#endif /* TICKSCHEDULER_H */
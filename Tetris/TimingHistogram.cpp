@@ -0,0 +1,136 @@
+#include "TimingHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+// constructor, empty
+TimingHistogram::TimingHistogram()
+{
+	clear();
+}
+
+// count a duration
+// - param 1: the duration (negative counts as 0)
+// - return: nothing
+void TimingHistogram::record(std::chrono::nanoseconds duration)
+{
+	if (duration.count() < 0)
+	{
+		duration = std::chrono::nanoseconds::zero();
+	}
+	buckets[getBucketIndex(static_cast<unsigned long long>(duration.count()))]++;
+	count++;
+	total += duration;
+	max = std::max(max, duration);
+}
+
+// count every duration another histogram has
+// - param 1: the other TimingHistogram
+// - return: nothing
+void TimingHistogram::add(const TimingHistogram& other)
+{
+	for (int i = 0; i < BUCKET_COUNT; i++)
+	{
+		buckets[i] += other.buckets[i];
+	}
+	count += other.count;
+	total += other.total;
+	max = std::max(max, other.max);
+}
+
+// forget every duration
+// - params: none
+// - return: nothing
+void TimingHistogram::clear()
+{
+	std::fill(buckets, buckets + BUCKET_COUNT, 0u);
+	count = 0;
+	total = std::chrono::nanoseconds::zero();
+	max = std::chrono::nanoseconds::zero();
+}
+
+// - return: the number of durations recorded
+unsigned long long TimingHistogram::getCount() const
+{
+	return count;
+}
+
+// - return: the mean duration (0 if none)
+std::chrono::nanoseconds TimingHistogram::getMean() const
+{
+	if (count == 0)
+	{
+		return std::chrono::nanoseconds::zero();
+	}
+	return total / static_cast<std::chrono::nanoseconds::rep>(count);
+}
+
+// - return: the longest duration (0 if none)
+std::chrono::nanoseconds TimingHistogram::getMax() const
+{
+	return max;
+}
+
+// the duration a percentage of the recorded durations are at or under
+//   (the top of its bucket, so never more than getMax())
+// - param 1: the percentage, 0 to 100
+// - return: the duration (0 if none)
+std::chrono::nanoseconds TimingHistogram::getPercentile(double percent) const
+{
+	if (count == 0)
+	{
+		return std::chrono::nanoseconds::zero();
+	}
+	percent = std::min(std::max(percent, 0.0), 100.0);
+	// the rank of the duration wanted, counting from 1
+	unsigned long long rank = static_cast<unsigned long long>(std::ceil(percent / 100.0 * count));
+	rank = std::min(std::max(rank, 1ull), count);
+
+	unsigned long long seen = 0;
+	for (int i = 0; i < BUCKET_COUNT; i++)
+	{
+		seen += buckets[i];
+		if (seen >= rank && i < BUCKET_COUNT - 1)
+		{
+			const std::chrono::nanoseconds top{ static_cast<std::chrono::nanoseconds::rep>(getBucketTop(i)) };
+			return std::min(top, max);
+		}
+	}
+	return max;	// in the last bucket, which has no top
+}
+
+// Durations under SUB_BUCKETS ns get a bucket each. Longer ones are bucketed
+// by their top SUB_BUCKET_BITS + 1 bits, so each power of two gets
+// SUB_BUCKETS buckets, following on from the exact ones.
+// - param 1: a duration in ns
+// - return: the index of the bucket it's counted in
+int TimingHistogram::getBucketIndex(unsigned long long value)
+{
+	if (value < SUB_BUCKETS)
+	{
+		return static_cast<int>(value);
+	}
+	int bits = 0;	// the bits needed for value
+	for (unsigned long long rest = value; rest != 0; rest >>= 1)
+	{
+		bits++;
+	}
+	if (bits > MAX_BITS)
+	{
+		return BUCKET_COUNT - 1;
+	}
+	const int shift = bits - SUB_BUCKET_BITS - 1;
+	return SUB_BUCKETS * shift + static_cast<int>(value >> shift);
+}
+
+// - param 1: a bucket index
+// - return: the largest duration in ns counted in that bucket
+unsigned long long TimingHistogram::getBucketTop(int index)
+{
+	if (index < SUB_BUCKETS)
+	{
+		return static_cast<unsigned long long>(index);
+	}
+	const int shift = index / SUB_BUCKETS - 1;
+	const unsigned long long top = static_cast<unsigned long long>(index - SUB_BUCKETS * shift);
+	return ((top + 1) << shift) - 1;
+}
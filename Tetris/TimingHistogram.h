@@ -0,0 +1,75 @@
+// A TimingHistogram counts durations in log-linear buckets (the layout
+// HdrHistogram uses), so percentiles can be read back from a fixed amount of
+// memory however many durations are recorded.
+//
+// Each power of two range of nanoseconds is split into SUB_BUCKETS equal
+// buckets, so a percentile is reported to within 1/SUB_BUCKETS (6.25%) of
+// the recorded value, and durations under SUB_BUCKETS ns exactly.
+// The maximum is tracked exactly. Durations of 2^MAX_BITS ns (about 2.4 hours)
+// or more are counted in the last bucket.
+// Recording is a few shifts & an increment, and never allocates.
+
+#ifndef TIMINGHISTOGRAM_H
+#define TIMINGHISTOGRAM_H
+
+#include <chrono>
+
+class TimingHistogram
+{
+public:
+	static const int SUB_BUCKET_BITS = 4;
+	static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;	// buckets per power of two
+	static const int MAX_BITS = 43;		// durations are counted up to 2^MAX_BITS ns
+	static const int BUCKET_COUNT = SUB_BUCKETS * (MAX_BITS - SUB_BUCKET_BITS + 1);
+
+private:
+	unsigned int buckets[BUCKET_COUNT];
+	unsigned long long count{ 0 };		// durations recorded
+	std::chrono::nanoseconds total{ 0 };	// their sum (for the mean)
+	std::chrono::nanoseconds max{ 0 };	// the longest
+
+public:
+	// constructor, empty
+	TimingHistogram();
+
+	// count a duration
+	// - param 1: the duration (negative counts as 0)
+	// - return: nothing
+	void record(std::chrono::nanoseconds duration);
+
+	// count every duration another histogram has
+	// - param 1: the other TimingHistogram
+	// - return: nothing
+	void add(const TimingHistogram& other);
+
+	// forget every duration
+	// - params: none
+	// - return: nothing
+	void clear();
+
+	// - return: the number of durations recorded
+	unsigned long long getCount() const;
+
+	// - return: the mean duration (0 if none)
+	std::chrono::nanoseconds getMean() const;
+
+	// - return: the longest duration (0 if none)
+	std::chrono::nanoseconds getMax() const;
+
+	// the duration a percentage of the recorded durations are at or under
+	//   (the top of its bucket, so never more than getMax())
+	// - param 1: the percentage, 0 to 100
+	// - return: the duration (0 if none)
+	std::chrono::nanoseconds getPercentile(double percent) const;
+
+private:
+	// - param 1: a duration in ns
+	// - return: the index of the bucket it's counted in
+	static int getBucketIndex(unsigned long long value);
+
+	// - param 1: a bucket index
+	// - return: the largest duration in ns counted in that bucket
+	static unsigned long long getBucketTop(int index);
+};
+
+#endif /* TIMINGHISTOGRAM_H */
@@ -0,0 +1,73 @@
+// A lock-free triple buffer for handing the latest value from one thread to another.
+//
+// The writer fills getWriteBuffer() and publish()es it, the reader calls
+// update() and reads getReadBuffer(). There are three buffers: the writer's,
+// the reader's, and the most recently published one in the middle. Publishing
+// and updating just swap a buffer with the middle one (one atomic exchange),
+// so neither thread ever waits for the other, the reader always gets the
+// newest published value, and values the reader was too slow to see are skipped.
+//
+// Exactly one thread may write and one thread may read.
+// After publish() the write buffer is an older value, so write every field each time.
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer
+{
+private:
+	static const unsigned int INDEX_MASK = 3;
+	static const unsigned int FRESH = 4;	// set in middle when it holds a value the reader hasn't taken
+
+	T buffers[3];
+	unsigned int writeIndex{ 0 };			// only touched by the writer
+	std::atomic<unsigned int> middle{ 1 };	// the buffer between the two, plus the FRESH flag
+	unsigned int readIndex{ 2 };			// only touched by the reader
+
+public:
+	TripleBuffer() = default;
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// writer: the buffer to fill before the next publish()
+	// - params: none
+	// - return: the write buffer
+	T& getWriteBuffer()
+	{
+		return buffers[writeIndex];
+	}
+
+	// writer: make the write buffer the newest value, and take the middle buffer to write next
+	// - params: none
+	// - return: nothing
+	void publish()
+	{
+		writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// reader: take the newest published value, if there's one the reader hasn't seen
+	// - params: none
+	// - return: true if getReadBuffer() changed
+	bool update()
+	{
+		if ((middle.load(std::memory_order_relaxed) & FRESH) == 0)
+		{
+			return false;
+		}
+		readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	// reader: the value taken by the last update()
+	// - params: none
+	// - return: the read buffer
+	const T& getReadBuffer() const
+	{
+		return buffers[readIndex];
+	}
+};
+
+#endif /* TRIPLEBUFFER_H */
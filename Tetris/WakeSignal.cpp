@@ -0,0 +1,87 @@
+#include "WakeSignal.h"
+#include <algorithm>
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+const std::chrono::nanoseconds WakeSignal::FALLBACK_POLL_INTERVAL{ std::chrono::milliseconds(10) };
+
+#ifdef _WIN32
+
+// constructor, not notified
+WakeSignal::WakeSignal()
+	: event{ CreateEvent(nullptr, FALSE, FALSE, nullptr) }
+{
+}
+
+// destructor
+WakeSignal::~WakeSignal()
+{
+	CloseHandle(static_cast<HANDLE>(event));
+}
+
+// wake the waiting thread (or the next wait(), if none is waiting)
+// - params: none
+// - return: nothing
+void WakeSignal::notify()
+{
+	SetEvent(static_cast<HANDLE>(event));
+}
+
+// sleep until notify()ed, input arrives for this thread or the timeout passes
+// - param 1: the longest to sleep (nanoseconds::max() has no limit)
+// - return: true if it was notify()ed (taking the notification)
+bool WakeSignal::wait(std::chrono::nanoseconds timeout)
+{
+	DWORD milliseconds = INFINITE;
+	if (timeout < std::chrono::hours(24))
+	{
+		// round up, so a wait for a deadline doesn't wake just before it
+		const long long rounded = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::max(timeout, std::chrono::nanoseconds::zero()) + std::chrono::nanoseconds(999999)).count();
+		milliseconds = static_cast<DWORD>(rounded);
+	}
+	HANDLE handle = static_cast<HANDLE>(event);
+	// MWMO_INPUTAVAILABLE: also wake for input already queued but not yet seen by a wait
+	return MsgWaitForMultipleObjectsEx(1, &handle, milliseconds, QS_ALLINPUT, MWMO_INPUTAVAILABLE) == WAIT_OBJECT_0;
+}
+
+#else
+
+// constructor, not notified
+WakeSignal::WakeSignal()
+{
+}
+
+// destructor
+WakeSignal::~WakeSignal()
+{
+}
+
+// wake the waiting thread (or the next wait(), if none is waiting)
+// - params: none
+// - return: nothing
+void WakeSignal::notify()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		notified = true;
+	}
+	condition.notify_one();
+}
+
+// sleep until notify()ed or the timeout (at most FALLBACK_POLL_INTERVAL) passes
+// - param 1: the longest to sleep (nanoseconds::max() has no limit)
+// - return: true if it was notify()ed (taking the notification)
+bool WakeSignal::wait(std::chrono::nanoseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait_for(lock, std::min(timeout, FALLBACK_POLL_INTERVAL), [this]() { return notified; });
+	const bool wasNotified = notified;
+	notified = false;
+	return wasNotified;
+}
+
+#endif
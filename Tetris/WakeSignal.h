@@ -0,0 +1,61 @@
+// A WakeSignal lets one thread sleep until another has something for it.
+//
+// The simulation thread notify()s it after publishing a GameSnapshot, and the
+// window thread wait()s on it between frames. A notify() is remembered until
+// the next wait() takes it, so one can't be lost between the window thread
+// checking for a snapshot and going to sleep.
+//
+// On Windows the wait also ends as soon as input reaches the waiting thread's
+// message queue (MsgWaitForMultipleObjectsEx), so the window thread sleeps
+// until a key press, a window event, a new snapshot or its own deadline.
+// SFML has no wait like that (its waitEvent() polls every 10 ms itself), so
+// elsewhere the wait also ends every FALLBACK_POLL_INTERVAL, for the window
+// to poll its events.
+
+#ifndef WAKESIGNAL_H
+#define WAKESIGNAL_H
+
+#include <chrono>
+#ifndef _WIN32
+#include <condition_variable>
+#include <mutex>
+#endif
+
+class WakeSignal
+{
+public:
+	static const std::chrono::nanoseconds FALLBACK_POLL_INTERVAL;	// init to 10 ms (not used on Windows)
+
+private:
+#ifdef _WIN32
+	void* event;					// a Win32 auto-reset event HANDLE
+#else
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool notified{ false };
+#endif
+
+public:
+	// constructor, not notified
+	WakeSignal();
+
+	// destructor
+	~WakeSignal();
+
+	WakeSignal(const WakeSignal&) = delete;
+	WakeSignal& operator=(const WakeSignal&) = delete;
+
+	// wake the waiting thread (or the next wait(), if none is waiting)
+	//   (any thread)
+	// - params: none
+	// - return: nothing
+	void notify();
+
+	// sleep until notify()ed, input arrives for this thread (Windows) or the timeout passes
+	//   (one thread)
+	// - param 1: the longest to sleep (nanoseconds::max() has no limit)
+	// - return: true if it was notify()ed (taking the notification)
+	bool wait(std::chrono::nanoseconds timeout);
+};
+
+#endif /* WAKESIGNAL_H */
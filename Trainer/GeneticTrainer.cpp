@@ -0,0 +1,269 @@
+#include "GeneticTrainer.h"
+#include "TetrisSimulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+
+namespace
+{
+	const char* const CHECKPOINT_MAGIC = "TetrisTrainerCheckpoint";
+	const int CHECKPOINT_VERSION = 1;
+	const double PI = 3.14159265358979323846;
+
+	// splitmix64 finalizer, spreads neighbouring inputs over the whole range
+	std::uint64_t mix(std::uint64_t value)
+	{
+		value += 0x9E3779B97F4A7C15ull;
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+		return value ^ (value >> 31);
+	}
+}
+
+// constructor - seed the rng and create a random population
+// - param 1: the Settings
+// - param 2: the TaskPool the games are played on
+GeneticTrainer::GeneticTrainer(const Settings& settings, TaskPool& pool)
+	: settings(settings), pool(pool), rng{ mix(settings.seed) }
+{
+	population.resize(static_cast<std::size_t>(std::max(settings.populationSize, 1)));
+	for (Candidate& candidate : population)
+	{
+		for (double& weight : candidate.weights.values)
+		{
+			weight = nextUniform() * 2.0 - 1.0;
+		}
+		normalize(candidate.weights);
+	}
+}
+
+// play every candidate's games and sort the population by fitness
+// - return: what the games cost
+GeneticTrainer::GenerationStats GeneticTrainer::evaluate()
+{
+	const int games = settings.gamesPerCandidate;
+	const int taskCount = static_cast<int>(population.size()) * games;
+	std::vector<int> lines(static_cast<std::size_t>(taskCount));
+	std::vector<int> pieces(static_cast<std::size_t>(taskCount));
+
+	const auto start = std::chrono::steady_clock::now();
+	auto playOne = [&](int task) {
+		const Candidate& candidate = population[static_cast<std::size_t>(task / games)];
+		lines[task] = playGame(candidate.weights, getGameSeed(generation, task % games), settings.maxPiecesPerGame, pieces[task]);
+	};
+	pool.parallelFor(taskCount, playOne);
+	const auto end = std::chrono::steady_clock::now();
+
+	// summed in a fixed order, so the result doesn't depend on the thread count
+	GenerationStats stats;
+	stats.games = taskCount;
+	stats.seconds = std::chrono::duration<double>(end - start).count();
+	for (std::size_t i = 0; i < population.size(); i++)
+	{
+		long long total = 0;
+		for (int game = 0; game < games; game++)
+		{
+			total += lines[i * games + game];
+			stats.pieces += pieces[i * games + game];
+		}
+		population[i].fitness = static_cast<double>(total) / std::max(games, 1);
+	}
+	std::stable_sort(population.begin(), population.end(),
+		[](const Candidate& a, const Candidate& b) { return a.fitness > b.fitness; });
+	return stats;
+}
+
+// replace the population with the next generation (call after evaluate())
+// - return: nothing
+void GeneticTrainer::breed()
+{
+	const std::size_t eliteCount = std::min(population.size(), static_cast<std::size_t>(std::max(settings.eliteCount, 0)));
+	std::vector<Candidate> next(population.begin(), population.begin() + eliteCount);
+	while (next.size() < population.size())
+	{
+		const Candidate& a = selectParent();
+		const Candidate& b = selectParent();
+
+		// lean towards the fitter parent (an even blend if neither scored)
+		const double total = a.fitness + b.fitness;
+		const double share = total > 0.0 ? a.fitness / total : 0.5;
+		Candidate child;
+		for (int i = 0; i < TetrisBot::FEATURE_COUNT; i++)
+		{
+			child.weights.values[i] = a.weights.values[i] * share + b.weights.values[i] * (1.0 - share);
+		}
+		if (nextUniform() < settings.mutationChance)
+		{
+			const int feature = static_cast<int>(nextUniform() * TetrisBot::FEATURE_COUNT);
+			child.weights.values[feature] += nextGaussian() * settings.mutationSize;
+		}
+		normalize(child.weights);
+		next.push_back(child);
+	}
+	population.swap(next);
+	generation++;
+}
+
+int GeneticTrainer::getGeneration() const
+{
+	return generation;
+}
+
+const std::vector<GeneticTrainer::Candidate>& GeneticTrainer::getPopulation() const
+{
+	return population;
+}
+
+const GeneticTrainer::Settings& GeneticTrainer::getSettings() const
+{
+	return settings;
+}
+
+// the seed of one of a generation's games, shared by every candidate
+// - param 1: the generation
+// - param 2: the game index
+// - return: the seed
+std::uint64_t GeneticTrainer::getGameSeed(int generation, int game) const
+{
+	return mix(mix(mix(settings.seed) ^ static_cast<std::uint64_t>(generation)) ^ static_cast<std::uint64_t>(game));
+}
+
+// play one headless game with a bot
+// - param 1: the bot's Weights
+// - param 2: the game seed
+// - param 3: the piece limit
+// - param 4: out, the pieces placed
+// - return: the lines cleared
+int GeneticTrainer::playGame(const TetrisBot::Weights& weights, std::uint64_t seed, int maxPieces, int& pieces)
+{
+	TetrisSimulation simulation(seed);
+	TetrisBot bot(nullptr, weights);
+	int lines = 0;
+	pieces = 0;
+	while (pieces < maxPieces && bot.play(simulation))
+	{
+		pieces++;
+		simulation.processGameLoop(0.0f);
+		if (simulation.getGamesLost() > 0)
+		{
+			break;		// topped out (the simulation has already reset)
+		}
+		lines = simulation.getLinesCleared();
+	}
+	return lines;
+}
+
+// a uniform double in [0, 1)
+double GeneticTrainer::nextUniform()
+{
+	return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// a normally distributed double
+double GeneticTrainer::nextGaussian()
+{
+	const double u1 = 1.0 - nextUniform();		// (0, 1], keeps log() finite
+	const double u2 = nextUniform();
+	return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * PI * u2);
+}
+
+// scale weights to unit length
+void GeneticTrainer::normalize(TetrisBot::Weights& weights)
+{
+	double length = 0.0;
+	for (double weight : weights.values)
+	{
+		length += weight * weight;
+	}
+	length = std::sqrt(length);
+	if (length > 0.0)
+	{
+		for (double& weight : weights.values)
+		{
+			weight /= length;
+		}
+	}
+}
+
+// pick a parent, the fittest of tournamentSize random candidates
+const GeneticTrainer::Candidate& GeneticTrainer::selectParent()
+{
+	std::size_t best = population.size();
+	for (int i = 0; i < std::max(settings.tournamentSize, 1); i++)
+	{
+		const std::size_t pick = static_cast<std::size_t>(nextUniform() * population.size());
+		// the population is sorted, so a lower index is at least as fit
+		best = std::min(best, pick);
+	}
+	return population[best];
+}
+
+// save the whole trainer state as text
+// - param 1: the stream
+void GeneticTrainer::saveCheckpoint(std::ostream& out) const
+{
+	const auto precision = out.precision(std::numeric_limits<double>::max_digits10);
+	out << CHECKPOINT_MAGIC << ' ' << CHECKPOINT_VERSION << '\n';
+	out << settings.seed << ' ' << settings.populationSize << ' ' << settings.gamesPerCandidate << ' '
+		<< settings.maxPiecesPerGame << ' ' << settings.eliteCount << ' ' << settings.tournamentSize << ' '
+		<< settings.mutationChance << ' ' << settings.mutationSize << '\n';
+	out << generation << '\n';
+	out << rng << '\n';
+	out << population.size() << '\n';
+	for (const Candidate& candidate : population)
+	{
+		for (double weight : candidate.weights.values)
+		{
+			out << weight << ' ';
+		}
+		out << candidate.fitness << '\n';
+	}
+	out.precision(precision);
+}
+
+// restore the whole trainer state
+// - param 1: the stream
+// - return: false if the stream didn't hold a checkpoint, the trainer is unchanged
+bool GeneticTrainer::loadCheckpoint(std::istream& in)
+{
+	std::string magic;
+	int version = 0;
+	if (!(in >> magic >> version) || magic != CHECKPOINT_MAGIC || version != CHECKPOINT_VERSION)
+	{
+		return false;
+	}
+	Settings loadedSettings;
+	int loadedGeneration = 0;
+	std::mt19937_64 loadedRng;
+	std::size_t count = 0;
+	in >> loadedSettings.seed >> loadedSettings.populationSize >> loadedSettings.gamesPerCandidate
+		>> loadedSettings.maxPiecesPerGame >> loadedSettings.eliteCount >> loadedSettings.tournamentSize
+		>> loadedSettings.mutationChance >> loadedSettings.mutationSize
+		>> loadedGeneration >> loadedRng >> count;
+	if (!in || count == 0)
+	{
+		return false;
+	}
+	std::vector<Candidate> loadedPopulation(count);
+	for (Candidate& candidate : loadedPopulation)
+	{
+		for (double& weight : candidate.weights.values)
+		{
+			in >> weight;
+		}
+		in >> candidate.fitness;
+	}
+	if (!in)
+	{
+		return false;
+	}
+	settings = loadedSettings;
+	generation = loadedGeneration;
+	rng = loadedRng;
+	population.swap(loadedPopulation);
+	return true;
+}
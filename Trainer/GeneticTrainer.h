@@ -0,0 +1,109 @@
+// The GeneticTrainer tunes TetrisBot weights by playing headless games.
+//
+// Each generation every candidate plays the same set of seeded games
+// (so candidates are compared on equal pieces), and its fitness is the
+// average number of lines it cleared before topping out or hitting the
+// piece limit. The fittest candidates survive unchanged, the rest of the
+// population is bred from tournament-selected parents: a fitness weighted
+// blend of 2 parents, sometimes mutated, normalized to unit length (only the
+// direction of a weight vector changes how the bot plays).
+//
+// Everything is driven by one seed, so the same seed and settings train
+// the same population, on any number of threads. The games of a generation
+// are spread across cores with a TaskPool (one single threaded bot per game).
+
+#ifndef GENETICTRAINER_H
+#define GENETICTRAINER_H
+
+#include "TaskPool.h"
+#include "TetrisBot.h"
+#include <cstdint>
+#include <iosfwd>
+#include <random>
+#include <vector>
+
+class GeneticTrainer
+{
+public:
+	struct Settings
+	{
+		std::uint64_t seed{ 1 };
+		int populationSize{ 64 };
+		int gamesPerCandidate{ 4 };		// games each candidate plays per generation
+		int maxPiecesPerGame{ 500 };	// a game stops here if the bot hasn't topped out
+		int eliteCount{ 8 };			// the best candidates kept unchanged
+		int tournamentSize{ 4 };
+		double mutationChance{ 0.2 };	// chance a child has one weight nudged
+		double mutationSize{ 0.2 };		// standard deviation of the nudge
+	};
+
+	struct Candidate
+	{
+		TetrisBot::Weights weights;
+		double fitness{ 0.0 };			// average lines cleared, from the last evaluate()
+	};
+
+	// what one generation's games cost
+	struct GenerationStats
+	{
+		long long games{ 0 };
+		long long pieces{ 0 };
+		double seconds{ 0.0 };
+	};
+
+private:
+	Settings settings;
+	TaskPool& pool;
+	std::mt19937_64 rng;				// breeding & initial population
+	int generation{ 0 };
+	std::vector<Candidate> population;	// sorted fittest first after evaluate()
+
+	// a uniform double in [0, 1)
+	double nextUniform();
+	// a normally distributed double (Box-Muller, so results don't depend on the standard library)
+	double nextGaussian();
+	// scale weights to unit length
+	static void normalize(TetrisBot::Weights& weights);
+	// pick a parent, the fittest of tournamentSize random candidates
+	const Candidate& selectParent();
+
+public:
+	// constructor - seed the rng and create a random population
+	// - param 1: the Settings
+	// - param 2: the TaskPool the games are played on
+	GeneticTrainer(const Settings& settings, TaskPool& pool);
+
+	// play every candidate's games and sort the population by fitness
+	// - return: what the games cost
+	GenerationStats evaluate();
+
+	// replace the population with the next generation (call after evaluate())
+	// - return: nothing
+	void breed();
+
+	int getGeneration() const;
+	const std::vector<Candidate>& getPopulation() const;
+	const Settings& getSettings() const;
+
+	// the seed of one of a generation's games, shared by every candidate
+	// - param 1: the generation
+	// - param 2: the game index
+	// - return: the seed
+	std::uint64_t getGameSeed(int generation, int game) const;
+
+	// play one headless game with a bot
+	// - param 1: the bot's Weights
+	// - param 2: the game seed
+	// - param 3: the piece limit
+	// - param 4: out, the pieces placed
+	// - return: the lines cleared
+	static int playGame(const TetrisBot::Weights& weights, std::uint64_t seed, int maxPieces, int& pieces);
+
+	// save / restore the whole trainer state (settings, generation, rng, population) as text
+	// - param 1: the stream
+	// - return: (load) false if the stream didn't hold a checkpoint, the trainer is unchanged
+	void saveCheckpoint(std::ostream& out) const;
+	bool loadCheckpoint(std::istream& in);
+};
+
+#endif /* GENETICTRAINER_H */
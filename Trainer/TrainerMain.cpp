@@ -0,0 +1,132 @@
+// Headless trainer for the TetrisBot's heuristic weights.
+//
+// usage: Trainer [--seed N] [--population N] [--generations N] [--games N]
+//                [--max-pieces N] [--threads N] [--checkpoint FILE]
+//                [--checkpoint-every N] [--resume FILE]
+//
+// Every generation prints the best & average fitness (lines per game),
+// the best weights and the engine throughput (games/sec and pieces/sec).
+
+#include "GeneticTrainer.h"
+#include "TaskPool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	void printUsage()
+	{
+		std::cout << "usage: Trainer [--seed N] [--population N] [--generations N] [--games N]\n"
+			<< "               [--max-pieces N] [--threads N] [--checkpoint FILE]\n"
+			<< "               [--checkpoint-every N] [--resume FILE]\n";
+	}
+
+	// write the checkpoint beside the old one and swap it in, so a crash never leaves half a file
+	bool writeCheckpoint(const GeneticTrainer& trainer, const std::string& path)
+	{
+		const std::string temporaryPath = path + ".tmp";
+		{
+			std::ofstream out(temporaryPath, std::ios::trunc);
+			trainer.saveCheckpoint(out);
+			if (!out)
+			{
+				return false;
+			}
+		}
+		std::remove(path.c_str());
+		return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	GeneticTrainer::Settings settings;
+	int generations = 100;
+	unsigned int threads = TaskPool::getDefaultWorkerCount();
+	std::string checkpointPath{ "trainer_checkpoint.txt" };
+	int checkpointEvery = 1;
+	std::string resumePath;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string option{ argv[i] };
+		if (i + 1 >= argc)
+		{
+			printUsage();
+			return 1;
+		}
+		const char* value = argv[++i];
+		if (option == "--seed") settings.seed = std::strtoull(value, nullptr, 10);
+		else if (option == "--population") settings.populationSize = std::atoi(value);
+		else if (option == "--generations") generations = std::atoi(value);
+		else if (option == "--games") settings.gamesPerCandidate = std::atoi(value);
+		else if (option == "--max-pieces") settings.maxPiecesPerGame = std::atoi(value);
+		else if (option == "--threads") threads = static_cast<unsigned int>(std::max(std::atoi(value) - 1, 0));
+		else if (option == "--checkpoint") checkpointPath = value;
+		else if (option == "--checkpoint-every") checkpointEvery = std::max(std::atoi(value), 1);
+		else if (option == "--resume") resumePath = value;
+		else {
+			printUsage();
+			return 1;
+		}
+	}
+	if (settings.populationSize < 2 || settings.gamesPerCandidate < 1)
+	{
+		printUsage();
+		return 1;
+	}
+	settings.eliteCount = std::min(settings.eliteCount, settings.populationSize / 4);
+
+	TaskPool pool(threads);
+	GeneticTrainer trainer(settings, pool);
+	if (!resumePath.empty())
+	{
+		std::ifstream in(resumePath);
+		if (!trainer.loadCheckpoint(in))
+		{
+			std::cerr << "Unable to resume from " << resumePath << "\n";
+			return 1;
+		}
+		std::cout << "Resumed at generation " << trainer.getGeneration() << "\n";
+	}
+	std::cout << "seed " << trainer.getSettings().seed << ", population " << trainer.getSettings().populationSize
+		<< ", " << pool.getWorkerCount() + 1 << " threads\n";
+
+	while (trainer.getGeneration() < generations)
+	{
+		const GeneticTrainer::GenerationStats stats = trainer.evaluate();
+		const std::vector<GeneticTrainer::Candidate>& population = trainer.getPopulation();
+		double average = 0.0;
+		for (const GeneticTrainer::Candidate& candidate : population)
+		{
+			average += candidate.fitness;
+		}
+		average /= population.size();
+
+		std::printf("generation %d: best %.2f avg %.2f lines/game | %.1f games/s %.0f pieces/s\n",
+			trainer.getGeneration(), population.front().fitness, average,
+			stats.games / stats.seconds, stats.pieces / stats.seconds);
+		std::printf("  best weights:");
+		for (double weight : population.front().weights.values)
+		{
+			std::printf(" %.6f", weight);
+		}
+		std::printf("\n");
+		std::fflush(stdout);
+
+		trainer.breed();
+		if (trainer.getGeneration() % checkpointEvery == 0 || trainer.getGeneration() == generations)
+		{
+			if (!writeCheckpoint(trainer, checkpointPath))
+			{
+				std::cerr << "Unable to write checkpoint " << checkpointPath << "\n";
+			}
+		}
+	}
+	return 0;
+}